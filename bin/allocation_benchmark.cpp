@@ -0,0 +1,134 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+#include "../src/pso/global_classic/global_classic.hpp"
+
+// Counts the heap allocations of the swarm iteration (velocity update,
+// clamp and position update), without the objective function, to show
+// that the steady-state iteration does not allocate.
+
+static std::atomic<long> allocations(0);
+
+#ifndef __MAC__
+extern "C" void *__libc_malloc(size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    // Every allocation (operator new, Eigen, GMP/MPFR) goes through malloc.
+
+    allocations++;
+
+    return __libc_malloc(size);
+}
+#else
+void *operator new(std::size_t size)
+{
+    allocations++;
+
+    void *ptr = std::malloc(size);
+
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Empty>
+class Benchmark_Swarm : public Global_Classic_Internal<Type, Type_Arr, Type_Vec, Type_Empty>
+{
+  public:
+    Benchmark_Swarm(const pso_params<Type, Type_Arr> &p, std::string var_type)
+        : Global_Classic_Internal<Type, Type_Arr, Type_Vec, Type_Empty>(p, var_type) {};
+
+    void setup()
+    {
+        // Initialize the swarm and use the sphere function as the fitness,
+        // so that the bests are valid.
+
+        this->initialize_arrays();
+
+        this->fpopul = Type_Vec(this->p.popsize);
+
+        for (int i = 0; i < this->p.popsize; i++)
+        {
+            this->fpopul(i) = this->popul.col(i).square().sum();
+        }
+
+        this->bestpos = this->popul;
+        this->fbestpos = this->fpopul;
+        this->fbestpos.minCoeff(&(this->g));
+    }
+
+    void step(Type w)
+    {
+        this->velocity_update(w);
+        this->swarm_update();
+    }
+};
+
+template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Empty>
+void run(const pso_params<Type, Type_Arr> &p, std::string var_type, int iterations)
+{
+    Benchmark_Swarm<Type, Type_Arr, Type_Vec, Type_Empty> swarm(p, var_type);
+
+    swarm.setup();
+    swarm.step(p.max_w); // Warm-up iteration.
+
+    long start_allocations = allocations;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; i++)
+    {
+        swarm.step(p.max_w);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    long total = allocations - start_allocations;
+
+    std::cout << "|- " << var_type << std::endl;
+    std::cout << "|- Allocations per iteration : " << double(total) / iterations << std::endl;
+    std::cout << "|- Time per iteration (us)   : "
+              << std::chrono::duration<double, std::micro>(end - start).count() / iterations << std::endl;
+}
+
+int main()
+{
+    MPFR_ARR bounds(2, 2);
+
+    pso_params<MP_REAL, MPFR_ARR> p;
+
+    bounds(0, 0) = -2.5;
+    bounds(0, 1) = 2.5;
+    bounds(1, 0) = -2.5;
+    bounds(1, 1) = 2.5;
+
+    p.dim = 2;
+    p.c1 = 2;
+    p.c2 = 1.7;
+    p.max_w = 0.5;
+    p.popsize = 20;
+    p.bounds = bounds;
+    p.seed = 1;
+
+    seed_rng(p.seed);
+
+    std::cout << "/---- Allocation Benchmark ----" << std::endl;
+
+    run<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY>(pso_params_to_double(p), "double", 10000);
+    run<MP_REAL, MPFR_ARR, MPFR_VEC, MPFR_EMPTY>(p, "mp_real", 1000);
+
+    std::cout << "\\------------------------------" << std::endl;
+
+    mpfr_free_cache();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,57 @@
+#include "../src/pso/batch/batch.hpp"
+
+int main()
+{
+    MPFR_ARR bounds(2, 2);
+
+    obj_params<MP_REAL> objp;
+    enhanced_params<MP_REAL> ep;
+    pso_params<MP_REAL, MPFR_ARR> p;
+
+    bounds(0, 0) = -2.165;
+    bounds(0, 1) = -2.164;
+    bounds(1, 0) = -0.63;
+    bounds(1, 1) = -0.62;
+
+    p.gm = 0;
+    p.dim = 2;
+    p.max_w = 0.5;
+    p.c1 = 2;
+    p.c2 = 1.7;
+    p.max_it = 15000;
+    p.bounds = bounds;
+    p.popsize = 20;
+    p.err_goal = 1e-8;
+    p.seed = 1;
+    p.tp.mode = "off";
+
+    objp.pc.p = 1;
+    objp.pc.ene = 17;
+    objp.pc.xpoin = -1.8019693;
+    objp.pc.threads = 15;
+    objp.pc.err_goal = 1e-8;
+
+    Batch *pso = Batch_Init(p, ep, 8, 1e-6);
+
+    if (pso == nullptr)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    pso->print_params();
+    pso->set_Obj_F("Poincare", objp);
+
+    std::vector<MPFR_ARR> minima = pso->fit();
+
+    for (int i = 0; i < int(minima.size()); i++)
+    {
+        std::cout << "Swarm " << i << ": " << ((minima[i].size() > 0) ? "Orbit Found" : "No Orbit") << std::endl;
+    }
+
+    delete pso;
+    pso = nullptr;
+
+    mpfr_free_cache();
+
+    return EXIT_SUCCESS;
+}
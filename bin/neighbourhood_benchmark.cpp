@@ -0,0 +1,242 @@
+#include <chrono>
+#include <cstdlib>
+
+#include "../src/pso/enhanced/local_classic/local_classic.hpp"
+
+// Compares the neighbourhood indices of the local PSO (LSH with and without
+// multi-probe queries, cell_list and kd_tree) in double:
+//  - the time to build an index and query every particle, and the recall of
+//    the neighbours against a brute-force search (the exact indices find
+//    all of them),
+//  - the best value that the local PSO finds with every index, and with the
+//    static topologies (ring, von_neumann and random), on the Rastrigin
+//    function, averaged over several seeds.
+
+typedef neighbourhood<double, DOUBLE_ARR, DOUBLE_VEC> Neighbourhood;
+
+Neighbourhood *new_index(const enhanced_params<double> &ep, const DOUBLE_ARR &bounds, const DOUBLE_ARR &population)
+{
+    if (ep.neighbourhood == "cell_list")
+    {
+        return new cell_list<double, DOUBLE_ARR, DOUBLE_VEC>(ep.lsh_radius, bounds, population);
+    }
+    else if (ep.neighbourhood == "kd_tree")
+    {
+        return new kd_tree<double, DOUBLE_ARR, DOUBLE_VEC>(ep.lsh_radius, bounds, population);
+    }
+
+    return new LSH<double, DOUBLE_ARR, DOUBLE_VEC>(ep.lsh_k, ep.lsh_w, ep.lsh_L, ep.lsh_probes, ep.lsh_radius, bounds,
+                                                   population);
+}
+
+std::vector<int> brute_force(const DOUBLE_VEC &particle, const enhanced_params<double> &ep, const DOUBLE_ARR &bounds,
+                             const DOUBLE_ARR &population)
+{
+    // The N closest particles in the search box, from all the particles.
+
+    int n = population.cols();
+    priority_list<double, DOUBLE_VEC> neighbours(n / 4, n);
+    DOUBLE_VEC half = (ep.lsh_radius / 2) * DOUBLE_VEC(bounds.col(1) - bounds.col(0));
+
+    neighbours.reset(particle);
+
+    for (int j = 0; j < n; j++)
+    {
+        if ((population.col(j) >= (particle - half).array() && population.col(j) < (particle + half).array()).all())
+        {
+            neighbours.add_particle(j, population.col(j).matrix());
+        }
+    }
+
+    std::vector<int> idx(neighbours.get_size());
+
+    for (int i = 0; i < neighbours.get_size(); i++)
+    {
+        idx[i] = neighbours.get_index(i);
+    }
+
+    std::sort(idx.begin(), idx.end());
+
+    return idx;
+}
+
+void query_benchmark(std::string label, const enhanced_params<double> &ep, int dim, int popsize, int repeats)
+{
+    DOUBLE_ARR bounds(dim, 2);
+
+    bounds.col(0).setConstant(-2.5);
+    bounds.col(1).setConstant(2.5);
+
+    double seconds = 0;
+    long found = 0;
+    long exact = 0;
+
+    for (int r = 0; r < repeats; r++)
+    {
+        DOUBLE_ARR population(dim, popsize);
+
+        uniform_real_fill(population, -2.5, 2.5);
+
+        auto start = std::chrono::steady_clock::now();
+
+        Neighbourhood *index = new_index(ep, bounds, population);
+        priority_list<double, DOUBLE_VEC> neighbours(index->get_neighbours(), popsize);
+        std::vector<Eigen::Vector<int, Eigen::Dynamic>> result(popsize);
+
+        for (int i = 0; i < popsize; i++)
+        {
+            result[i] = index->find_idx(population.col(i), neighbours);
+        }
+
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        delete index;
+
+        for (int i = 0; i < popsize; i++)
+        {
+            std::vector<int> reference = brute_force(population.col(i), ep, bounds, population);
+            std::vector<int> idx(result[i].data(), result[i].data() + result[i].size());
+
+            std::sort(idx.begin(), idx.end());
+
+            std::vector<int> common;
+            std::set_intersection(idx.begin(), idx.end(), reference.begin(), reference.end(),
+                                  std::back_inserter(common));
+
+            found += common.size();
+            exact += reference.size();
+        }
+    }
+
+    std::cout << "|- " << label << " (dim " << dim << ", popsize " << popsize << ")" << std::endl;
+    std::cout << "|-   Build and query (us)    : " << 1e6 * seconds / repeats << std::endl;
+    std::cout << "|-   Recall                  : " << ((exact > 0) ? double(found) / exact : 1.0) << std::endl;
+}
+
+class Benchmark_Swarm : public Local_Classic_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY>
+{
+  public:
+    Benchmark_Swarm(const pso_params<double, DOUBLE_ARR> &p, const enhanced_params<double> &ep)
+        : Local_Classic_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY>(p, ep, "double") {};
+
+    double run(int iterations)
+    {
+        // Run the local PSO on the Rastrigin function and return the best value.
+
+        this->initialize_arrays();
+        this->evaluate();
+        this->accept_evaluation("initial");
+
+        for (int i = 0; i < iterations; i++)
+        {
+            this->velocity_update(this->p.max_w - i * (this->p.max_w - this->p.min_w) / iterations);
+            this->swarm_update();
+            this->evaluate();
+            this->accept_evaluation("");
+        }
+
+        return this->fbestpos(this->g);
+    }
+
+  private:
+    void evaluate()
+    {
+        this->fpopul = DOUBLE_VEC(this->p.popsize);
+
+        for (int i = 0; i < this->p.popsize; i++)
+        {
+            this->fpopul(i) = 10 * this->p.dim + (this->popul.col(i).square() -
+                                                  10 * (2 * M_PI * this->popul.col(i)).cos()).sum();
+        }
+    }
+};
+
+void quality_benchmark(std::string label, const enhanced_params<double> &ep, int dim, int seeds, int iterations)
+{
+    pso_params<double, DOUBLE_ARR> p;
+    DOUBLE_ARR bounds(dim, 2);
+
+    bounds.col(0).setConstant(-5.12);
+    bounds.col(1).setConstant(5.12);
+
+    p.dim = dim;
+    p.c1 = 2;
+    p.c2 = 1.7;
+    p.max_w = 0.9;
+    p.min_w = 0.4;
+    p.popsize = 40;
+    p.bounds = bounds;
+
+    double best = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int s = 1; s <= seeds; s++)
+    {
+        seed_rng(s);
+
+        Benchmark_Swarm swarm(p, ep);
+
+        best += swarm.run(iterations);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "|- " << label << " (Rastrigin, dim " << dim << ")" << std::endl;
+    std::cout << "|-   Mean best value         : " << best / seeds << std::endl;
+    std::cout << "|-   Time per iteration (us) : " << 1e6 * seconds / (seeds * iterations) << std::endl;
+}
+
+int main()
+{
+    std::vector<std::string> labels = {"lsh", "lsh (L = 5)", "lsh (L = 5, 4 probes)", "cell_list", "kd_tree"};
+    std::vector<enhanced_params<double>> configs(labels.size());
+
+    configs[1].lsh_L = 5;
+    configs[2].lsh_L = 5;
+    configs[2].lsh_probes = 4;
+    configs[3].neighbourhood = "cell_list";
+    configs[4].neighbourhood = "kd_tree";
+
+    // The static topologies have no index to query.
+    std::vector<std::string> topologies = {"ring", "von_neumann", "random"};
+
+    seed_rng(1);
+
+    std::cout << "/---- Neighbourhood Benchmark ----" << std::endl;
+
+    for (int dim : {2, 4})
+    {
+        for (int popsize : {100, 1000})
+        {
+            for (int c = 0; c < int(configs.size()); c++)
+            {
+                query_benchmark(labels[c], configs[c], dim, popsize, 10);
+            }
+        }
+    }
+
+    std::cout << "|---------------------------------" << std::endl;
+
+    for (int dim : {2, 4})
+    {
+        for (int c = 0; c < int(configs.size()); c++)
+        {
+            quality_benchmark(labels[c], configs[c], dim, 10, 500);
+        }
+
+        for (std::string t : topologies)
+        {
+            enhanced_params<double> ep;
+
+            ep.neighbourhood = t;
+
+            quality_benchmark(t, ep, dim, 10, 500);
+        }
+    }
+
+    std::cout << "\\---------------------------------" << std::endl;
+
+    mpfr_free_cache();
+
+    return EXIT_SUCCESS;
+}
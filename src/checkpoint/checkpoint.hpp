@@ -0,0 +1,259 @@
+#ifndef __CKPT__
+#define __CKPT__
+
+#include <cstdio>
+#include <string>
+
+#include "../local_definitions.hpp"
+
+// The binary checkpoint files. Every file starts with a magic string and a
+// format version, the rest of the file is a sequence of fields in the order
+// they were written. The MPFR numbers are stored with mpfr_fpif_export(),
+// which keeps their precision and is portable between machines.
+
+#define CKPT_MAGIC "PSOCKPT"
+#define CKPT_VERSION 1
+
+class checkpoint_writer
+{
+    // Writes a checkpoint. The data goes to a temporary file, which replaces
+    // the checkpoint only when close() succeeds. A process that is killed
+    // while writing never leaves a broken checkpoint behind.
+
+  public:
+    checkpoint_writer(std::string file)
+    {
+        this->file = file;
+        this->good = true;
+        this->f = std::fopen((file + ".tmp").c_str(), "wb");
+
+        if (this->f == nullptr)
+        {
+            this->good = false;
+
+            return;
+        }
+
+        this->write(std::string(CKPT_MAGIC));
+        this->write(int(CKPT_VERSION));
+    }
+
+    ~checkpoint_writer()
+    {
+        if (this->f != nullptr)
+        { // The checkpoint was not closed, discard it.
+            std::fclose(this->f);
+            std::remove((this->file + ".tmp").c_str());
+        }
+    }
+
+    template <typename T> void write(const T &x)
+    {
+        // Plain values (int, long, double, ...).
+
+        if (this->good == true && std::fwrite(&x, sizeof(T), 1, this->f) != 1)
+        {
+            this->good = false;
+        }
+    }
+
+    void write(const std::string &s)
+    {
+        this->write(long(s.size()));
+
+        if (this->good == true && std::fwrite(s.data(), 1, s.size(), this->f) != s.size())
+        {
+            this->good = false;
+        }
+    }
+
+    void write(const MP_REAL &x)
+    {
+        if (this->good == true && mpfr_fpif_export(this->f, const_cast<mpfr_ptr>(x.mpfr_srcptr())) != 0)
+        {
+            this->good = false;
+        }
+    }
+
+    void write(const MPFR_ARR &a)
+    {
+        this->write(long(a.rows()));
+        this->write(long(a.cols()));
+
+        for (Eigen::Index i = 0; i < a.size(); i++)
+        {
+            this->write(a(i));
+        }
+    }
+
+    void write(const MPFR_VEC &v)
+    {
+        this->write(long(v.size()));
+
+        for (Eigen::Index i = 0; i < v.size(); i++)
+        {
+            this->write(v(i));
+        }
+    }
+
+    bool close()
+    {
+        // Returns false if the checkpoint could not be written.
+
+        if (this->f == nullptr)
+        {
+            return false;
+        }
+
+        this->good = (std::fflush(this->f) == 0) && this->good;
+        this->good = (std::fclose(this->f) == 0) && this->good;
+        this->f = nullptr;
+
+        if (this->good == true)
+        {
+            this->good = (std::rename((this->file + ".tmp").c_str(), this->file.c_str()) == 0);
+        }
+        else
+        {
+            std::remove((this->file + ".tmp").c_str());
+        }
+
+        return this->good;
+    }
+
+  private:
+    bool good;
+    FILE *f;
+    std::string file;
+};
+
+class checkpoint_reader
+{
+    // Reads a checkpoint, in the order it was written.
+    // After a failed read, is_good() returns false.
+
+  public:
+    checkpoint_reader(std::string file)
+    {
+        std::string magic;
+        int version = 0;
+
+        this->good = true;
+        this->f = std::fopen(file.c_str(), "rb");
+
+        if (this->f == nullptr)
+        {
+            this->good = false;
+
+            return;
+        }
+
+        this->read(magic);
+        this->read(version);
+
+        if (magic != CKPT_MAGIC || version != CKPT_VERSION)
+        {
+            this->good = false;
+        }
+    }
+
+    ~checkpoint_reader()
+    {
+        if (this->f != nullptr)
+        {
+            std::fclose(this->f);
+        }
+    }
+
+    inline bool is_good()
+    {
+        return this->good;
+    }
+
+    template <typename T> void read(T &x)
+    {
+        if (this->good == true && std::fread(&x, sizeof(T), 1, this->f) != 1)
+        {
+            this->good = false;
+        }
+    }
+
+    void read(std::string &s)
+    {
+        long size = 0;
+
+        this->read(size);
+
+        if (this->good == false || size < 0 || size > (1 << 20))
+        {
+            this->good = false;
+
+            return;
+        }
+
+        s.resize(size);
+
+        if (std::fread(s.data(), 1, size, this->f) != size_t(size))
+        {
+            this->good = false;
+        }
+    }
+
+    void read(MP_REAL &x)
+    {
+        if (this->good == true && mpfr_fpif_import(x.mpfr_ptr(), this->f) != 0)
+        {
+            this->good = false;
+        }
+    }
+
+    void read(MPFR_ARR &a)
+    {
+        long rows = 0;
+        long cols = 0;
+
+        this->read(rows);
+        this->read(cols);
+
+        if (this->good == false || rows < 0 || cols < 0)
+        {
+            this->good = false;
+
+            return;
+        }
+
+        a = MPFR_ARR(rows, cols);
+
+        for (Eigen::Index i = 0; i < a.size(); i++)
+        {
+            this->read(a(i));
+        }
+    }
+
+    void read(MPFR_VEC &v)
+    {
+        long size = 0;
+
+        this->read(size);
+
+        if (this->good == false || size < 0)
+        {
+            this->good = false;
+
+            return;
+        }
+
+        v = MPFR_VEC(size);
+
+        for (Eigen::Index i = 0; i < v.size(); i++)
+        {
+            this->read(v(i));
+        }
+    }
+
+  private:
+    bool good;
+    FILE *f;
+};
+
+#endif
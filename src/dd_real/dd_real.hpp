@@ -0,0 +1,699 @@
+#ifndef __DDREAL__
+#define __DDREAL__
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include <Eigen/Core>
+#include <mpreal.h>
+
+class dd_real
+{
+    // A double-double number: an unevaluated sum hi + lo of two doubles with
+    // |lo| <= ulp(hi) / 2, which gives about 32 significant digits. Every
+    // operation is a handful of inline double operations, without the heap
+    // allocated limbs of MPFR. The algorithms are the ones of the QD library
+    // (Hida, Li & Bailey), in their accurate (IEEE) variants.
+
+  public:
+    double hi;
+    double lo;
+
+    constexpr dd_real() : hi(0), lo(0) {};
+    constexpr dd_real(double hi) : hi(hi), lo(0) {};
+    constexpr dd_real(double hi, double lo) : hi(hi), lo(lo) {};
+
+    template <typename I, typename = std::enable_if_t<std::is_integral_v<I>>>
+    constexpr dd_real(I i) : hi(double(i)), lo(double(i - I(double(i))))
+    {
+    }
+
+    explicit dd_real(const mpfr::mpreal &x)
+    {
+        // Round to the nearest double-double.
+
+        this->hi = double(x);
+        this->lo = std::isfinite(this->hi) ? double(x - this->hi) : 0;
+    }
+
+    explicit operator double() const
+    {
+        return this->hi;
+    }
+
+    template <typename I, typename = std::enable_if_t<std::is_integral_v<I>>> explicit operator I() const
+    {
+        return I(this->hi) + I(this->lo);
+    }
+
+    explicit operator mpfr::mpreal() const
+    {
+        return mpfr::mpreal(this->hi) + mpfr::mpreal(this->lo);
+    }
+
+    static inline void two_sum(double a, double b, double &s, double &e)
+    {
+        // s + e = a + b exactly.
+
+        s = a + b;
+
+        double v = s - a;
+
+        e = (a - (s - v)) + (b - v);
+    }
+
+    static inline void quick_two_sum(double a, double b, double &s, double &e)
+    {
+        // s + e = a + b exactly, if |a| >= |b|.
+
+        s = a + b;
+        e = b - (s - a);
+    }
+
+    static inline void two_prod(double a, double b, double &p, double &e)
+    {
+        // p + e = a * b exactly.
+
+        p = a * b;
+        e = std::fma(a, b, -p);
+    }
+
+    inline dd_real &operator+=(const dd_real &b)
+    {
+        double s, e, t, f;
+
+        two_sum(this->hi, b.hi, s, e);
+        two_sum(this->lo, b.lo, t, f);
+        e += t;
+        quick_two_sum(s, e, s, e);
+        e += f;
+        quick_two_sum(s, e, this->hi, this->lo);
+
+        return *this;
+    }
+
+    inline dd_real &operator+=(double b)
+    {
+        double s, e;
+
+        two_sum(this->hi, b, s, e);
+        e += this->lo;
+        quick_two_sum(s, e, this->hi, this->lo);
+
+        return *this;
+    }
+
+    inline dd_real &operator-=(const dd_real &b)
+    {
+        return (*this += dd_real(-b.hi, -b.lo));
+    }
+
+    inline dd_real &operator-=(double b)
+    {
+        return (*this += -b);
+    }
+
+    inline dd_real &operator*=(const dd_real &b)
+    {
+        double p, e;
+
+        two_prod(this->hi, b.hi, p, e);
+        e += this->hi * b.lo + this->lo * b.hi;
+        quick_two_sum(p, e, this->hi, this->lo);
+
+        return *this;
+    }
+
+    inline dd_real &operator*=(double b)
+    {
+        double p, e;
+
+        two_prod(this->hi, b, p, e);
+        e += this->lo * b;
+        quick_two_sum(p, e, this->hi, this->lo);
+
+        return *this;
+    }
+
+    inline dd_real &operator/=(const dd_real &b)
+    {
+        // Long division, with three partial quotients.
+
+        double q1 = this->hi / b.hi;
+
+        if (std::isfinite(q1) == false)
+        {
+            this->hi = q1;
+            this->lo = 0;
+
+            return *this;
+        }
+
+        dd_real r = *this;
+
+        r -= dd_real(b) *= q1;
+
+        double q2 = r.hi / b.hi;
+
+        r -= dd_real(b) *= q2;
+
+        double q3 = r.hi / b.hi;
+
+        quick_two_sum(q1, q2, this->hi, this->lo);
+
+        return (*this += q3);
+    }
+
+    inline dd_real &operator/=(double b)
+    {
+        return (*this /= dd_real(b));
+    }
+
+    inline dd_real operator-() const
+    {
+        return dd_real(-this->hi, -this->lo);
+    }
+
+    inline dd_real operator+() const
+    {
+        return *this;
+    }
+};
+
+// Arithmetic.
+
+#define DD_BINARY_OPERATOR(op)                                                                                         \
+    inline dd_real operator op(dd_real a, const dd_real &b)                                                           \
+    {                                                                                                                  \
+        return a op## = b;                                                                                             \
+    }                                                                                                                  \
+    inline dd_real operator op(dd_real a, double b)                                                                   \
+    {                                                                                                                  \
+        return a op## = b;                                                                                             \
+    }                                                                                                                  \
+    inline dd_real operator op(double a, const dd_real &b)                                                            \
+    {                                                                                                                  \
+        return dd_real(a) op## = b;                                                                                    \
+    }
+
+DD_BINARY_OPERATOR(+)
+DD_BINARY_OPERATOR(-)
+DD_BINARY_OPERATOR(*)
+DD_BINARY_OPERATOR(/)
+
+#undef DD_BINARY_OPERATOR
+
+// Comparisons.
+
+inline bool operator==(const dd_real &a, const dd_real &b)
+{
+    return a.hi == b.hi && a.lo == b.lo;
+}
+
+inline bool operator<(const dd_real &a, const dd_real &b)
+{
+    return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+inline bool operator==(const dd_real &a, double b)
+{
+    return a.hi == b && a.lo == 0;
+}
+
+inline bool operator<(const dd_real &a, double b)
+{
+    return a.hi < b || (a.hi == b && a.lo < 0);
+}
+
+inline bool operator>(const dd_real &a, double b)
+{
+    return a.hi > b || (a.hi == b && a.lo > 0);
+}
+
+inline bool operator!=(const dd_real &a, const dd_real &b)
+{
+    return !(a == b);
+}
+
+inline bool operator<=(const dd_real &a, const dd_real &b)
+{
+    return a < b || a == b;
+}
+
+inline bool operator>(const dd_real &a, const dd_real &b)
+{
+    return b < a;
+}
+
+inline bool operator>=(const dd_real &a, const dd_real &b)
+{
+    return b <= a;
+}
+
+inline bool operator!=(const dd_real &a, double b)
+{
+    return !(a == b);
+}
+
+inline bool operator<=(const dd_real &a, double b)
+{
+    return a < b || a == b;
+}
+
+inline bool operator>=(const dd_real &a, double b)
+{
+    return a > b || a == b;
+}
+
+inline bool operator==(double a, const dd_real &b)
+{
+    return b == a;
+}
+
+inline bool operator!=(double a, const dd_real &b)
+{
+    return b != a;
+}
+
+inline bool operator<(double a, const dd_real &b)
+{
+    return b > a;
+}
+
+inline bool operator>(double a, const dd_real &b)
+{
+    return b < a;
+}
+
+inline bool operator<=(double a, const dd_real &b)
+{
+    return b >= a;
+}
+
+inline bool operator>=(double a, const dd_real &b)
+{
+    return b <= a;
+}
+
+// Functions (found by argument-dependent lookup, e.g. by Eigen and odepack).
+
+inline bool isfinite(const dd_real &x)
+{
+    return std::isfinite(x.hi);
+}
+
+inline bool isinf(const dd_real &x)
+{
+    return std::isinf(x.hi);
+}
+
+inline bool isnan(const dd_real &x)
+{
+    return std::isnan(x.hi);
+}
+
+inline dd_real abs(const dd_real &x)
+{
+    return (x.hi < 0) ? -x : x;
+}
+
+inline dd_real fabs(const dd_real &x)
+{
+    return abs(x);
+}
+
+inline dd_real floor(const dd_real &x)
+{
+    double hi = std::floor(x.hi);
+    double lo = 0;
+
+    if (hi == x.hi)
+    { // hi is already an integer, floor the low part.
+        lo = std::floor(x.lo);
+        dd_real::quick_two_sum(hi, lo, hi, lo);
+    }
+
+    return dd_real(hi, lo);
+}
+
+inline dd_real ceil(const dd_real &x)
+{
+    return -floor(-x);
+}
+
+inline dd_real sqrt(const dd_real &x)
+{
+    // One Newton step from the double square root (Karp's trick).
+
+    if (x.hi <= 0)
+    {
+        return dd_real((x.hi == 0) ? 0.0 : std::numeric_limits<double>::quiet_NaN());
+    }
+
+    double r = 1.0 / std::sqrt(x.hi);
+    double ax = x.hi * r;
+    double p, e;
+
+    dd_real::two_prod(ax, ax, p, e);
+
+    return dd_real(ax) + ((x - dd_real(p, e)).hi * r * 0.5);
+}
+
+inline dd_real ldexp(const dd_real &x, int e)
+{
+    return dd_real(std::ldexp(x.hi, e), std::ldexp(x.lo, e));
+}
+
+inline dd_real expm1_reduced(const dd_real &x)
+{
+    // exp(x) - 1 for |x| <= ln(2) / 2: exp(r) - 1 from its Taylor series, with
+    // r = x / 1024, then squared ten times as (1 + s)^2 - 1 = s * (2 + s).
+
+    dd_real r = ldexp(x, -10);
+    dd_real s = r;
+    dd_real term = r;
+
+    for (int i = 2; i < 12; i++)
+    {
+        term *= r;
+        term /= double(i);
+        s += term;
+
+        if (std::abs(term.hi) <= 1e-36 * std::abs(s.hi))
+        {
+            break;
+        }
+    }
+
+    for (int i = 0; i < 10; i++)
+    {
+        s *= (s + 2.0);
+    }
+
+    return s;
+}
+
+inline dd_real exp(const dd_real &x)
+{
+    // exp(x) = 2^m * exp(x - m * ln(2)).
+
+    const dd_real ln2(6.931471805599452862e-01, 2.319046813846299558e-17);
+
+    if (x.hi > 709.79)
+    {
+        return dd_real(std::numeric_limits<double>::infinity());
+    }
+    else if (x.hi < -745.2)
+    {
+        return dd_real(0.0);
+    }
+
+    double m = std::floor(x.hi / ln2.hi + 0.5);
+
+    return ldexp(expm1_reduced(x - ln2 * m) + 1.0, int(m));
+}
+
+inline dd_real expm1(const dd_real &x)
+{
+    if (std::abs(x.hi) > 0.34)
+    {
+        return exp(x) - 1.0;
+    }
+
+    return expm1_reduced(x);
+}
+
+inline dd_real tanh(const dd_real &x)
+{
+    // tanh(x) = (exp(2x) - 1) / (exp(2x) + 1), without the cancellation near 0.
+
+    if (std::abs(x.hi) > 40)
+    {
+        return dd_real((x.hi > 0) ? 1.0 : -1.0);
+    }
+
+    dd_real s = expm1(2.0 * x);
+
+    return s / (s + 2.0);
+}
+
+inline dd_real log(const dd_real &x)
+{
+    // One Newton step from the double logarithm: y = y + x * exp(-y) - 1.
+
+    if (x.hi <= 0)
+    {
+        return dd_real((x.hi == 0) ? -std::numeric_limits<double>::infinity()
+                                   : std::numeric_limits<double>::quiet_NaN());
+    }
+
+    dd_real y(std::log(x.hi));
+
+    return y + x * exp(-y) - 1.0;
+}
+
+template <typename I, typename = std::enable_if_t<std::is_integral_v<I>>> inline dd_real pow(const dd_real &base, I n)
+{
+    // Binary powering (exact exponent).
+
+    dd_real result(1.0);
+    dd_real b = base;
+    bool negative = false;
+    unsigned long long k = n;
+
+    if constexpr (std::is_signed_v<I>)
+    {
+        negative = (n < 0);
+        k = negative ? (0ULL - (unsigned long long)n) : (unsigned long long)n;
+    }
+
+    while (k > 0)
+    {
+        if (k & 1)
+        {
+            result *= b;
+        }
+
+        k >>= 1;
+
+        if (k > 0)
+        {
+            b *= b;
+        }
+    }
+
+    return negative ? (1.0 / result) : result;
+}
+
+inline dd_real pow(const dd_real &base, const dd_real &exponent)
+{
+    if (exponent == floor(exponent) && std::abs(exponent.hi) < 1e9)
+    {
+        return pow(base, long(exponent.hi));
+    }
+
+    return exp(exponent * log(base));
+}
+
+inline dd_real pow(const dd_real &base, double exponent)
+{
+    return pow(base, dd_real(exponent));
+}
+
+inline dd_real max(const dd_real &a, const dd_real &b)
+{
+    return (a < b) ? b : a;
+}
+
+inline dd_real min(const dd_real &a, const dd_real &b)
+{
+    return (b < a) ? b : a;
+}
+
+inline std::string to_string(const dd_real &x, int digits)
+{
+    // The decimal scientific representation of x, with the given significant digits.
+
+    if (std::isfinite(x.hi) == false || x.hi == 0)
+    {
+        std::ostringstream out;
+
+        out << x.hi;
+
+        return out.str();
+    }
+
+    std::string result = (x.hi < 0) ? "-" : "";
+    dd_real r = abs(x);
+    int e = int(std::floor(std::log10(r.hi)));
+
+    r = (e >= 0) ? (r / pow(dd_real(10.0), e)) : (r * pow(dd_real(10.0), -e));
+
+    if (r.hi >= 10)
+    {
+        r /= 10.0;
+        e++;
+    }
+    else if (r.hi < 1)
+    {
+        r *= 10.0;
+        e--;
+    }
+
+    std::string mantissa;
+
+    for (int i = 0; i <= digits; i++)
+    { // One more digit, for the rounding.
+        int d = int(std::floor(r.hi));
+
+        d = (d < 0) ? 0 : ((d > 9) ? 9 : d);
+        mantissa += char('0' + d);
+        r = (r - double(d)) * 10.0;
+    }
+
+    if (mantissa.back() >= '5')
+    { // Round the last digit.
+        int i = digits - 1;
+
+        while (i >= 0 && mantissa[i] == '9')
+        {
+            mantissa[i--] = '0';
+        }
+
+        if (i >= 0)
+        {
+            mantissa[i]++;
+        }
+        else
+        {
+            mantissa.insert(mantissa.begin(), '1');
+            e++;
+        }
+    }
+
+    mantissa.resize(digits);
+
+    result += mantissa.substr(0, 1);
+
+    if (digits > 1)
+    {
+        result += "." + mantissa.substr(1);
+    }
+
+    result += "e" + std::string((e < 0) ? "-" : "+") + std::to_string(std::abs(e));
+
+    return result;
+}
+
+inline std::ostream &operator<<(std::ostream &out, const dd_real &x)
+{
+    // Up to the precision of double, x prints like a double.
+
+    if (out.precision() <= std::numeric_limits<double>::max_digits10)
+    {
+        return out << x.hi;
+    }
+
+    return out << to_string(x, int(out.precision()));
+}
+
+template <> class std::numeric_limits<dd_real>
+{
+  public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr int digits = 106;
+    static constexpr int digits10 = 31;
+    static constexpr int max_digits10 = 33;
+    static constexpr int radix = 2;
+
+    static constexpr dd_real epsilon()
+    {
+        return dd_real(4.93038065763132e-32); // 2^-104
+    }
+
+    static constexpr dd_real min()
+    {
+        return dd_real(2.0041683600089728e-292); // 2^-969, so that lo stays normal.
+    }
+
+    static constexpr dd_real max()
+    {
+        return dd_real(1.79769313486231570815e+308, 9.97920154767359795037e+291);
+    }
+
+    static constexpr dd_real lowest()
+    {
+        return dd_real(-1.79769313486231570815e+308, -9.97920154767359795037e+291);
+    }
+
+    static constexpr dd_real infinity()
+    {
+        return dd_real(std::numeric_limits<double>::infinity());
+    }
+
+    static constexpr dd_real quiet_NaN()
+    {
+        return dd_real(std::numeric_limits<double>::quiet_NaN());
+    }
+};
+
+namespace Eigen
+{
+
+template <> struct NumTraits<dd_real> : GenericNumTraits<dd_real>
+{
+    enum
+    {
+        IsInteger = 0,
+        IsSigned = 1,
+        IsComplex = 0,
+        RequireInitialization = 0,
+        ReadCost = 2,
+        AddCost = 20,
+        MulCost = 10
+    };
+
+    typedef dd_real Real;
+    typedef dd_real NonInteger;
+    typedef dd_real Literal;
+    typedef dd_real Nested;
+
+    static inline dd_real epsilon()
+    {
+        return std::numeric_limits<dd_real>::epsilon();
+    }
+
+    static inline dd_real dummy_precision()
+    {
+        return dd_real(1e-28);
+    }
+
+    static inline dd_real highest()
+    {
+        return std::numeric_limits<dd_real>::max();
+    }
+
+    static inline dd_real lowest()
+    {
+        return std::numeric_limits<dd_real>::lowest();
+    }
+
+    static inline int digits10()
+    {
+        return std::numeric_limits<dd_real>::digits10;
+    }
+};
+
+} // namespace Eigen
+
+#endif
@@ -1,56 +1,153 @@
 #include <random>
+#include <vector>
 
 #include "functions.hpp"
 
+static uint64_t splitmix64(uint64_t &x)
+{
+    // Used to expand a 64-bit seed into the 256-bit state of the engine.
+
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+void xoshiro256::seed(uint64_t seed, uint64_t stream)
+{
+    // The stream is mixed into the seed, so that e.g. every grid cell
+    // can use the same user seed and still get its own sequence.
+
+    uint64_t x = seed ^ (0xD1B54A32D192ED03ULL * (stream + 1));
+
+    for (int i = 0; i < 4; i++)
+    {
+        this->s[i] = splitmix64(x);
+    }
+}
+
+xoshiro256 &rng()
+{
+    // Return the engine of the calling thread. Until it is seeded
+    // explicitly with seed_rng(), it is seeded once from std::random_device.
+
+    thread_local xoshiro256 engine((uint64_t(std::random_device{}()) << 32) | std::random_device{}());
+
+    return engine;
+}
+
+void seed_rng(uint64_t seed, uint64_t stream)
+{
+    // Reseed the engine of the calling thread, to make a run reproducible.
+
+    rng().seed(seed, stream);
+}
+
 double uniform_real(double a, double b)
 {
     // Return a real number using the Uniform distribution.
+    // The 53 high bits of the engine output are mapped to [0,1).
+
+    return a + (b - a) * (double(rng()() >> 11) * 0x1.0p-53);
+}
+
+void uniform_real_fill(double *data, Eigen::Index n, double a, double b)
+{
+    // Fill n doubles with U(a,b) numbers. The engine output is drawn in
+    // chunks and then converted in a separate loop, which the compiler
+    // can vectorize, instead of converting one number per call.
+
+    constexpr Eigen::Index chunk = 256;
+    int64_t bits[chunk];
+    double scale = (b - a) * 0x1.0p-53;
+
+    xoshiro256 &engine = rng();
+
+    for (Eigen::Index start = 0; start < n; start += chunk)
+    {
+        Eigen::Index len = std::min(chunk, n - start);
 
-    std::random_device random_seed;
-    std::default_random_engine generator(random_seed());
-    std::uniform_real_distribution<double> U(a, b);
+        for (Eigen::Index i = 0; i < len; i++)
+        {
+            bits[i] = int64_t(engine() >> 11);
+        }
 
-    return U(generator);
+        for (Eigen::Index i = 0; i < len; i++)
+        {
+            data[start + i] = a + double(bits[i]) * scale;
+        }
+    }
+}
+
+void uniform_real_fill(DOUBLE_ARR &arr, double a, double b)
+{
+    // Fill a preallocated double array with U(a,b) numbers.
+
+    uniform_real_fill(arr.data(), arr.size(), a, b);
+}
+
+void uniform_real_fill(MPFR_ARR &arr, double a, double b)
+{
+    // Fill a preallocated MPFR array with U(a,b) numbers. The numbers are
+    // generated in bulk as doubles and then assigned in place, so the
+    // existing MPFR elements are reused instead of constructed.
+
+    thread_local std::vector<double> buffer;
+
+    buffer.resize(arr.size());
+    uniform_real_fill(buffer.data(), arr.size(), a, b);
+
+    for (Eigen::Index i = 0; i < arr.size(); i++)
+    {
+        arr(i) = buffer[i];
+    }
+}
+
+void uniform_real_fill(DD_ARR &arr, double a, double b)
+{
+    // Fill a preallocated double-double array with U(a,b) numbers
+    // (with the same random sequence as a double array).
+
+    thread_local std::vector<double> buffer;
+
+    buffer.resize(arr.size());
+    uniform_real_fill(buffer.data(), arr.size(), a, b);
+
+    for (Eigen::Index i = 0; i < arr.size(); i++)
+    {
+        arr(i) = buffer[i];
+    }
 }
 
 double gauss_distribution(double mean, double stddev)
 {
     // Return a real number using the Gaussian (Normal) distribution.
 
-    std::random_device random_seed;
-    std::mt19937 generator(random_seed());
     std::normal_distribution<double> Gauss(mean, stddev);
 
-    return Gauss(generator);
+    return Gauss(rng());
 }
 
-MPFR_ARR double_to_mpfr_ARR(DOUBLE_ARR arr)
+MPFR_ARR double_to_mpfr_ARR(const DOUBLE_ARR &arr)
 {
     // Turn a double eigen array to an MPFR eigen array.
 
-    MPFR_ARR mp_arr(arr.rows(), arr.cols());
+    MPFR_ARR mp_arr;
 
-    for (int i = 0; i < arr.rows(); i++)
-    {
-        for (int j = 0; j < arr.cols(); j++)
-        {
-            mp_arr(i, j) = MP_REAL(arr(i, j));
-        }
-    }
+    cast_into(arr, mp_arr);
 
     return mp_arr;
 }
 
-MPFR_VEC double_to_mpfr_VEC(DOUBLE_VEC vec)
+MPFR_VEC double_to_mpfr_VEC(const DOUBLE_VEC &vec)
 {
     // Turn a double eigen vector to an MPFR eigen vector.
 
-    MPFR_VEC mp_vec(vec.rows(), vec.cols());
+    MPFR_VEC mp_vec;
 
-    for (int i = 0; i < vec.rows(); i++)
-    {
-        mp_vec(i) = MP_REAL(vec(i));
-    }
+    cast_into(vec, mp_vec);
 
     return mp_vec;
 }
@@ -59,26 +156,18 @@ uint64_t uniform_int(uint64_t a, uint64_t b)
 {
     // Return an integer using Uniform distribution.
 
-    std::random_device random_seed;
-    std::default_random_engine generator(random_seed());
     std::uniform_int_distribution<uint64_t> U(a, b);
 
-    return U(generator);
+    return U(rng());
 }
 
-DOUBLE_ARR mpfr_to_double_ARR(MPFR_ARR arr)
+DOUBLE_ARR mpfr_to_double_ARR(const MPFR_ARR &arr)
 {
     // Turn an MPFR eigen array to a double eigen array.
 
-    DOUBLE_ARR db_arr(arr.rows(), arr.cols());
+    DOUBLE_ARR db_arr;
 
-    for (int i = 0; i < arr.rows(); i++)
-    {
-        for (int j = 0; j < arr.cols(); j++)
-        {
-            db_arr(i, j) = double(arr(i, j));
-        }
-    }
+    cast_into(arr, db_arr);
 
     return db_arr;
 }
@@ -3,14 +3,99 @@
 
 #include "../local_definitions.hpp"
 
+class xoshiro256
+{
+    // A xoshiro256** pseudo-random engine. It satisfies the
+    // UniformRandomBitGenerator requirements, so it can be used with
+    // the std:: distributions. Every (seed, stream) pair produces an
+    // independent, reproducible sequence.
+
+  public:
+    using result_type = uint64_t;
+
+    xoshiro256(uint64_t seed = 0, uint64_t stream = 0)
+    {
+        this->seed(seed, stream);
+    }
+
+    void seed(uint64_t seed, uint64_t stream = 0);
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return UINT64_MAX;
+    }
+
+    inline result_type operator()()
+    {
+        uint64_t result = rotl(this->s[1] * 5, 7) * 9;
+        uint64_t t = this->s[1] << 17;
+
+        this->s[2] ^= this->s[0];
+        this->s[3] ^= this->s[1];
+        this->s[1] ^= this->s[2];
+        this->s[0] ^= this->s[3];
+        this->s[2] ^= t;
+        this->s[3] = rotl(this->s[3], 45);
+
+        return result;
+    }
+
+  private:
+    uint64_t s[4]; // The state of the engine.
+
+    static inline uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+xoshiro256 &rng();
+void seed_rng(uint64_t seed, uint64_t stream = 0);
+
 double uniform_real(double a, double b);
+void uniform_real_fill(double *data, Eigen::Index n, double a, double b);
+void uniform_real_fill(DOUBLE_ARR &arr, double a, double b);
+void uniform_real_fill(MPFR_ARR &arr, double a, double b);
+void uniform_real_fill(DD_ARR &arr, double a, double b);
 double gauss_distribution(double mean, double stddev);
 
-MPFR_ARR double_to_mpfr_ARR(DOUBLE_ARR arr);
-MPFR_VEC double_to_mpfr_VEC(DOUBLE_VEC vec);
+MPFR_ARR double_to_mpfr_ARR(const DOUBLE_ARR &arr);
+MPFR_VEC double_to_mpfr_VEC(const DOUBLE_VEC &vec);
 
 uint64_t uniform_int(uint64_t a, uint64_t b = INT_MAX);
 
-DOUBLE_ARR mpfr_to_double_ARR(MPFR_ARR arr);
+DOUBLE_ARR mpfr_to_double_ARR(const MPFR_ARR &arr);
+
+template <typename Src, typename Dst> void cast_into(const Src &src, Dst &dst)
+{
+    // Convert an eigen array (or vector) into a preallocated target of another
+    // scalar type. The target is resized only if its shape differs, otherwise
+    // its elements are assigned in place (an MPFR element keeps its limbs).
+
+    typedef typename Src::Scalar Src_Scalar;
+    typedef typename Dst::Scalar Dst_Scalar;
+
+    if (dst.rows() != src.rows() || dst.cols() != src.cols())
+    {
+        dst.resize(src.rows(), src.cols());
+    }
+
+    for (Eigen::Index i = 0; i < src.size(); i++)
+    {
+        if constexpr (std::is_assignable_v<Dst_Scalar &, const Src_Scalar &>)
+        {
+            dst(i) = src(i);
+        }
+        else
+        {
+            dst(i) = static_cast<Dst_Scalar>(src(i));
+        }
+    }
+}
 
 #endif
@@ -126,16 +126,52 @@ MPFR_ARR grid_search(grid_params gp, double swap_point, int precision, std::stri
     std::cout << "Complete." << std::endl;
     std::cout << "Running " << grid_size << " threads, in batches of " << gp.batch_size << ".\n" << std::endl;
 
-    init_folder(gp.dest);
+    if (gp.resume == false)
+    {
+        init_folder(gp.dest);
+    }
+    else
+    { // Keep the checkpoints and the minima of the finished subspaces.
+        std::filesystem::create_directories(gp.dest);
+    }
 
     auto thread_task = [&](int id, pso_params<MP_REAL, MPFR_ARR> p, enhanced_params<MP_REAL> ep,
                            obj_params<MP_REAL> objp, int precision, std::string type) {
         MPFR_ARR min; // The minimum found in this thread.
         std::string file_name = gp.dest + "/Grid_Search_Global_Classic_PSO_" + std::to_string(id) +
                                 ".txt"; // The output file of this thread.
-        std::ofstream output(file_name);
+        std::string minima_file = gp.dest + "/Minima_" + std::to_string(id) + ".bin"; // The minima of this thread.
+        std::ofstream output(file_name, (gp.resume == true) ? std::ios::app : std::ios::out);
+        bool restored = false;
+
+        p.stream = id; // Every grid cell draws from its own random stream.
+
+        if (p.tp.file != "")
+        { // Every grid cell writes its records to its own file.
+            std::string extension = (p.tp.format == "binary") ? ".bin" : (p.tp.format == "csv") ? ".csv" : ".txt";
+
+            p.tp.file = gp.dest + "/Telemetry_" + std::to_string(id) + extension;
+        }
+
+        if (p.checkpoint != "")
+        { // Every grid cell has its own checkpoint.
+            p.checkpoint = gp.dest + "/Checkpoint_" + std::to_string(id) + ".bin";
+
+            if (gp.resume == true)
+            { // If this subspace was finished before, restore its minima.
+                checkpoint_reader r(minima_file);
+
+                r.read(min);
 
-        if (type == "Global_Classic")
+                restored = r.is_good();
+            }
+        }
+
+        if (restored == true)
+        {
+            output << "~> The subspace was finished before, its minima are restored." << std::endl;
+        }
+        else if (type == "Global_Classic")
         {
             Global_Classic *global_classic_pso = Global_Classic_Init(p, swap_point, precision, &output);
 
@@ -172,6 +208,18 @@ MPFR_ARR grid_search(grid_params gp, double swap_point, int precision, std::stri
             }
         }
 
+        if (p.checkpoint != "" && restored == false)
+        { // Mark the subspace as finished.
+            checkpoint_writer w(minima_file);
+
+            w.write(min);
+
+            if (w.close() == false)
+            {
+                output << "~> Error: The minima of the subspace could not be saved." << std::endl;
+            }
+        }
+
         {
             std::lock_guard<std::mutex> lock(mutex); // One thread allowed to enter at a time.
 
@@ -10,6 +10,7 @@ struct grid_params
     int batch_size = 1;
     std::string dest = "test";
     std::string type = "Global_Classic";
+    bool resume = false; // Resume a grid search from its checkpoints (p.checkpoint should be set).
 
     obj_params<MP_REAL> objp;
     enhanced_params<MP_REAL> ep;
@@ -5,6 +5,8 @@
 #include <limits>
 #include <unsupported/Eigen/MPRealSupport>
 
+#include "dd_real/dd_real.hpp"
+
 #ifndef MP_REAL
 #define MP_REAL mpfr::mpreal
 #endif
@@ -33,6 +35,22 @@
 #define DOUBLE_EMPTY Eigen::Array<double, Eigen::Dynamic, 1>
 #endif
 
+#ifndef DD_REAL
+#define DD_REAL dd_real
+#endif
+
+#ifndef DD_VEC
+#define DD_VEC Eigen::Vector<DD_REAL, Eigen::Dynamic>
+#endif
+
+#ifndef DD_ARR
+#define DD_ARR Eigen::Array<DD_REAL, Eigen::Dynamic, Eigen::Dynamic>
+#endif
+
+#ifndef DD_EMPTY
+#define DD_EMPTY Eigen::Array<DD_REAL, Eigen::Dynamic, 1>
+#endif
+
 namespace lmath
 { // Local custom math functions.
 
@@ -76,6 +94,26 @@ inline mpfr::mpreal pow(const mpfr::mpreal &base, const mpfr::mpreal &exp)
     return mpfr::pow(base, exp);
 }
 
+inline dd_real abs(const dd_real &x)
+{
+    return ::abs(x);
+}
+
+inline dd_real sqrt(const dd_real &x)
+{
+    return ::sqrt(x);
+}
+
+inline dd_real floor(const dd_real &x)
+{
+    return ::floor(x);
+}
+
+inline dd_real pow(const dd_real &base, const dd_real &exp)
+{
+    return ::pow(base, exp);
+}
+
 template <typename Type> inline Type get_infinity();
 
 template <> inline double get_infinity<double>()
@@ -88,6 +126,11 @@ template <> inline mpfr::mpreal get_infinity<mpfr::mpreal>()
     return mpfr::mpreal("inf");
 }
 
+template <> inline dd_real get_infinity<dd_real>()
+{
+    return std::numeric_limits<dd_real>::infinity();
+}
+
 template <typename Type> bool isinf(const Type &x);
 
 template <> inline bool isinf<double>(const double &x)
@@ -100,6 +143,11 @@ template <> inline bool isinf<mpfr::mpreal>(const mpfr::mpreal &x)
     return mpfr::isinf(x) != 0;
 }
 
+template <> inline bool isinf<dd_real>(const dd_real &x)
+{
+    return ::isinf(x);
+}
+
 } // namespace lmath
 
 #endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+#ifndef __HFAM__
+#define __HFAM__
+
+#include <algorithm>
+#include <vector>
+
+#include "../../functions/functions.hpp"
+#include "../../local_definitions.hpp"
+
+typedef Eigen::Array<uint64_t, Eigen::Dynamic, Eigen::Dynamic> HASH_ARR;
+
+template <typename Type, typename Type_Arr, typename Type_Vec> class hash_family
+{
+    // The hash functions g() of all the L hash tables. Every g() is made of k
+    // functions h(x) = floor((v * x + b) / w), where v is a random vector
+    // initialized with the Gaussian distribution and b a real number sampled
+    // from [0,w), and g(x) = (r_1 h_1(x) + ... + r_k h_k(x)) mod M.
+    // The vectors v of all the k * L functions h() are the rows of one
+    // projection array, so the hashes of a whole population are computed with
+    // one matrix product.
+
+  public:
+    hash_family(int d, int w, int k, int L)
+    {
+        this->k = k;
+        this->L = L;
+        this->w = w;
+        this->M = pow(2, 32) - 5;
+        this->V = Type_Arr(k * L, d);
+        this->b = Type_Vec(k * L);
+        this->r_ = std::vector<uint64_t>(k * L);
+
+        for (int i = 0; i < k * L; i++)
+        {
+            // The h() functions of the first g(), then of the second, ...
+
+            this->b(i) = uniform_real(0, w);
+
+            for (int j = 0; j < d; j++)
+            {
+                this->V(i, j) = Type(gauss_distribution(0, 1));
+            }
+
+            this->r_[i] = uniform_int(0, this->M);
+        }
+    }
+
+    HASH_ARR calculate_ids(const Type_Arr &particles) const
+    {
+        // The ids of the particles (the columns) for every g() (the rows).
+
+        return this->ids_of((this->V.matrix() * particles.matrix()).array());
+    }
+
+    HASH_ARR calculate_ids(const Type_Vec &particle) const
+    {
+        return this->ids_of((this->V.matrix() * particle.matrix()).array());
+    }
+
+    HASH_ARR probe_ids(const Type_Vec &particle, int probes) const
+    {
+        // The ids of the buckets that a query visits in every hash table
+        // (multi-probe LSH): the id of the particle (column 0), and the ids of
+        // the probes adjacent buckets that are closest to it (columns 1 to
+        // probes, the closest first). An adjacent bucket differs in one h()
+        // by +1 or -1, and its distance is how far the projection of the
+        // particle is from the window boundary in that direction.
+
+        if (probes == 0)
+        {
+            return this->calculate_ids(particle);
+        }
+
+        Type_Vec projections = this->V.matrix() * particle.matrix();
+        HASH_ARR ids(this->L, probes + 1);
+
+        std::vector<uint64_t> h(this->k);
+        std::vector<uint64_t> h_minus(this->k);
+        std::vector<uint64_t> h_plus(this->k);
+
+        // The (distance, step) of every adjacent bucket. Step j < k is
+        // h_j - 1 and step k + j is h_j + 1.
+        std::vector<std::pair<double, int>> steps(2 * this->k);
+
+        for (int l = 0; l < this->L; l++)
+        {
+            uint64_t result = 0;
+
+            for (int j = 0; j < this->k; j++)
+            {
+                int m = l * this->k + j;
+                Type t = (projections(m) + this->b(m)) / this->w;
+                Type t_floor = lmath::floor(t);
+                double fraction = double(t - t_floor);
+
+                h[j] = uint64_t(t_floor);
+                h_minus[j] = uint64_t(t_floor - 1);
+                h_plus[j] = uint64_t(t_floor + 1);
+
+                steps[j] = std::pair<double, int>(fraction, j);
+                steps[this->k + j] = std::pair<double, int>(1 - fraction, this->k + j);
+
+                result += this->r_[m] * h[j];
+            }
+
+            ids(l, 0) = result % this->M;
+
+            std::partial_sort(steps.begin(), steps.begin() + probes, steps.end());
+
+            for (int p = 0; p < probes; p++)
+            {
+                int j = steps[p].second % this->k;
+                uint64_t r = this->r_[l * this->k + j];
+                uint64_t h_step = (steps[p].second < this->k) ? h_minus[j] : h_plus[j];
+
+                ids(l, p + 1) = (result - r * h[j] + r * h_step) % this->M;
+            }
+        }
+
+        return ids;
+    }
+
+  private:
+    int k;                    // Number of h() functions used for every g() function.
+    int L;                    // Number of g() functions (one for every hash table).
+    int w;                    // A "window" size.
+    uint64_t M;               // A large integer number.
+    Type_Arr V;               // The random vectors v of all the h() functions (as rows).
+    Type_Vec b;               // The real numbers b of all the h() functions.
+    std::vector<uint64_t> r_; // Random integer numbers.
+
+    HASH_ARR ids_of(const Type_Arr &projections) const
+    {
+        // Compute the ids from the projections v * x.
+
+        HASH_ARR ids(this->L, projections.cols());
+
+        for (int c = 0; c < int(projections.cols()); c++)
+        {
+            for (int l = 0; l < this->L; l++)
+            {
+                uint64_t result = 0;
+
+                for (int j = l * this->k; j < (l + 1) * this->k; j++)
+                {
+                    result += this->r_[j] * uint64_t(lmath::floor((projections(j, c) + this->b(j)) / this->w));
+                }
+
+                ids(l, c) = result % this->M;
+            }
+        }
+
+        return ids;
+    }
+};
+
+#endif
@@ -1,68 +1,85 @@
 #ifndef __HASH__
 #define __HASH__
 
-#include "bucket/bucket.hpp"
-#include "g_h/g_h.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
-template <typename Type, typename Type_Arr, typename Type_Vec> class hash_table
+class hash_table
 {
+    // The buckets are stored flat (CSR layout): the particle indices of all
+    // the buckets are in one array, sorted by bucket, and the indices of
+    // bucket b are indices[offsets[b]] ... indices[offsets[b + 1] - 1].
+    // The table holds only indices and the cached id of every particle, the
+    // ids are computed by the hash family of the LSH index.
+
   public:
-    hash_table(G<Type, Type_Vec> *g, Type_Arr population)
+    hash_table(int n)
     {
-        int n = population.cols();
+        this->bucket_num = std::max(1, n / 8); // Number of buckets (at least one, for small swarms).
+        this->offsets = std::vector<int>(this->bucket_num + 1);
+        this->indices = std::vector<int>(n);
+        this->ids = std::vector<uint64_t>(n);
+    }
 
-        this->g = g;
-        this->bucket_num = ceil(n / 8); // Number of buckets.
-        this->bucket_ = new bucket<Type_Vec> *[this->bucket_num];
+    inline void set_id(int i, uint64_t id)
+    {
+        // Set the id of a particle. The buckets are rebuilt with sort(),
+        // after the ids of all the (moved) particles are set.
 
-        for (int i = 0; i < this->bucket_num; i++)
-        {
-            this->bucket_[i] = new bucket<Type_Vec>;
-        }
+        this->ids[i] = id;
+    }
 
-        for (int i = 0; i < n; i++)
-        {
-            // For each particle calculate its hash and place it
-            // in the respective bucket.
+    inline uint64_t get_id(int i) const
+    {
+        return this->ids[i];
+    }
+
+    void sort()
+    {
+        // Place the particles in their buckets (counting sort on the bucket
+        // of every particle). In every bucket the particles are in descending
+        // index order.
 
-            int g_id = this->g->calculate_g(population.col(i), this->bucket_num);
+        int n = int(this->ids.size());
 
-            this->bucket_[g_id]->add_particle(i, population.col(i));
+        std::fill(this->offsets.begin(), this->offsets.end(), 0);
+
+        for (int i = 0; i < n; i++)
+        {
+            this->offsets[this->ids[i] % this->bucket_num + 1]++;
         }
-    }
 
-    ~hash_table()
-    {
-        for (int i = 0; i < this->bucket_num; i++)
+        for (int b = 0; b < this->bucket_num; b++)
         {
-            delete this->bucket_[i];
-            this->bucket_[i] = nullptr;
+            this->offsets[b + 1] += this->offsets[b];
         }
-        delete[] this->bucket_;
-        this->bucket_ = nullptr;
 
-        delete this->g;
-        this->g = nullptr;
+        std::vector<int> next(this->offsets.begin(), this->offsets.end() - 1);
+
+        for (int i = n - 1; i >= 0; i--)
+        {
+            this->indices[next[this->ids[i] % this->bucket_num]++] = i;
+        }
     }
 
-    item<Type_Vec> *get_bucket_items(Type_Vec particle)
+    const int *get_bucket_items(uint64_t id, int &size) const
     {
-        // Return the items stored in a specific bucket.
+        // Return the indices of the particles stored in the bucket of an id
+        // (and their number in size).
 
-        int g_id = this->g->calculate_g(particle, this->bucket_num);
+        int g_id = id % this->bucket_num;
 
-        return this->bucket_[g_id]->get_items();
-    }
+        size = this->offsets[g_id + 1] - this->offsets[g_id];
 
-    inline G<Type, Type_Vec> *get_hash_function()
-    {
-        return this->g;
-    };
+        return this->indices.data() + this->offsets[g_id];
+    }
 
   private:
-    G<Type, Type_Vec> *g;       // The hash function.
-    bucket<Type_Vec> **bucket_; // An array of the hash buckets.
-    int bucket_num;             // Number of buckets in the hash table.
+    int bucket_num;            // Number of buckets in the hash table.
+    std::vector<int> offsets;  // Where every bucket begins in indices (bucket_num + 1 entries).
+    std::vector<int> indices;  // The particle indices, sorted by bucket.
+    std::vector<uint64_t> ids; // The id of every particle.
 };
 
-#endif
\ No newline at end of file
+#endif
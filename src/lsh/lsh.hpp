@@ -1,26 +1,37 @@
 #ifndef __LSH__
 #define __LSH__
 
+#include "../neighbourhood/neighbourhood.hpp"
+#include "hash_family/hash_family.hpp"
 #include "hash_table/hash_table.hpp"
-#include "priority_list/priority_list.hpp"
 
-template <typename Type, typename Type_Arr, typename Type_Vec> class LSH
+template <typename Type, typename Type_Arr, typename Type_Vec>
+class LSH : public neighbourhood<Type, Type_Arr, Type_Vec>
 {
   public:
-    LSH(int k, int w, int L, Type err_goal, Type effective_radius, Type_Arr dim_limits, Type_Arr population)
+    LSH(int k, int w, int L, int probes, Type effective_radius, const Type_Arr &dim_limits,
+        const Type_Arr &population)
+        : neighbourhood<Type, Type_Arr, Type_Vec>(effective_radius, dim_limits, population)
     {
         this->L = L;
-        this->err_goal = 1e-4 * err_goal;
-        this->N = population.cols() / 4;
-        this->dim_limits = dim_limits;
-        this->effective_radius = effective_radius;
+        this->probes = probes;
 
-        this->HT = new hash_table<Type, Type_Arr, Type_Vec> *[this->L];
+        this->family = new hash_family<Type, Type_Arr, Type_Vec>(population.rows(), w, k, L);
+        this->HT = new hash_table *[this->L];
+
+        // The ids of all the particles for all the hash tables (one matrix product).
+        HASH_ARR ids = this->family->calculate_ids(this->population);
 
         for (int i = 0; i < this->L; i++)
         {
-            G<Type, Type_Vec> *g = new G<Type, Type_Vec>(population.rows(), w, k);
-            this->HT[i] = new hash_table<Type, Type_Arr, Type_Vec>(g, population);
+            this->HT[i] = new hash_table(population.cols());
+
+            for (int j = 0; j < int(population.cols()); j++)
+            {
+                this->HT[i]->set_id(j, ids(i, j));
+            }
+
+            this->HT[i]->sort();
         }
     }
 
@@ -33,110 +44,90 @@ template <typename Type, typename Type_Arr, typename Type_Vec> class LSH
         }
         delete[] this->HT;
         this->HT = nullptr;
+
+        delete this->family;
+        this->family = nullptr;
     }
 
-    priority_list<Type, Type_Vec> *find(Type_Vec particle)
+    void update(const Type_Arr &population) override
     {
-        priority_list<Type, Type_Vec> *neighbours = new priority_list<Type, Type_Vec>(this->err_goal, particle);
-        // Create a priority list for the neighbours. A priority list is needed
-        // because if/when the list reaches N+1 items, the farthest item should be
-        // removed. With a priority list, that item will always be the last item,
-        // making its removal time-efficient.
+        // Rehash the particles that moved since the index was built (or last
+        // updated), with the same hash functions, and rebuild the buckets.
 
-        for (int i = 0; i < this->L; i++)
-        { // For each hash table,
-            item<Type_Vec> *bucket_items =
-                this->HT[i]->get_bucket_items(particle); // get the items from the bucket that
-                                                         // the particle would be a part of,
-            uint64_t particle_id =
-                this->HT[i]->get_hash_function()->calculate_id(particle); // calculate the particle id for the
-                                                                          // specific hash table,
-            while (bucket_items)
-            {
-                int bucket_particle_idx = bucket_items->get_index();
-                Type_Vec bucket_particle(bucket_items->get_particle());
-
-                uint64_t item_id = this->HT[i]->get_hash_function()->calculate_id(
-                    bucket_particle); // and calculate the current item's hash id.
-
-                if (particle_id == item_id)
-                { // If the IDs match,
-                    if (this->effective_radius == 1)
-                    { // if the radius is 1,
-                        if (neighbours->particle_exists(bucket_particle) == false)
-                        { // and the item is not already in the neighbours list,
-                            neighbours->add_particle(bucket_particle_idx, bucket_particle); // add it to the list.
-                        }
-                    }
-                    else
-                    { // If effective_radius < 1, then calculate the new
-                      // search space.
-                        Type_Vec max_dim_distance = Type_Vec(this->dim_limits.col(1) - this->dim_limits.col(0));
-                        Type_Vec max_particle_radius = particle + ((this->effective_radius / 2) * max_dim_distance);
-                        Type_Vec min_particle_radius = particle - ((this->effective_radius / 2) * max_dim_distance);
-
-                        if ((bucket_particle.array() >= min_particle_radius.array() &&
-                             bucket_particle.array() < max_particle_radius.array())
-                                .all())
-                        { // If the item is in the effective radius
-                            if (neighbours->particle_exists(bucket_particle) == false)
-                            { // and it is not already in the neighbours list,
-                                neighbours->add_particle(bucket_particle_idx, bucket_particle); // add it to the list.
-                            }
-                        }
-                    }
+        std::vector<int> moved = this->moved(population);
 
-                    if (neighbours->get_size() > this->N)
-                    { // If the neighbours list has more than N items,
-                      // remove the farthest (=last) one.
-                        neighbours->remove_particle();
-                    }
-                }
+        if (moved.size() == 0)
+        {
+            return;
+        }
 
-                bucket_items = bucket_items->get_next();
+        HASH_ARR ids = this->family->calculate_ids(Type_Arr(this->population(Eigen::all, moved)));
+
+        for (int i = 0; i < this->L; i++)
+        {
+            for (int j = 0; j < int(moved.size()); j++)
+            {
+                this->HT[i]->set_id(moved[j], ids(i, j));
             }
-        }
 
-        return neighbours;
+            this->HT[i]->sort();
+        }
     }
 
-    Eigen::Vector<int, Eigen::Dynamic> find_idx(Type_Vec particle)
+    void find(const Type_Vec &particle, priority_list<Type, Type_Vec> &neighbours) const override
     {
-        priority_list<Type, Type_Vec> *neighbours =
-            this->find(particle); // Find the N closest neighbours of the particle,
+        // Collect the N closest neighbours of the particle in the priority
+        // list. The list is bounded, so when it is full the farthest neighbour
+        // is dropped.
 
-        Eigen::Vector<int, Eigen::Dynamic> idx(neighbours->get_size()); // create an integer array and
+        neighbours.reset(particle);
 
-        int i = 0;
-        priority_node<Type, Type_Vec> *temp = neighbours->get_items();
+        Type_Vec max_particle_radius;
+        Type_Vec min_particle_radius;
 
-        while (temp)
-        {
-            idx(i) = temp->get_index(); // save all the indices of the neighbours.
+        this->search_box(particle, min_particle_radius, max_particle_radius);
 
-            i++;
-            temp = temp->get_next();
-        }
+        // The ids of the buckets to visit in all the hash tables (the bucket
+        // of the particle and the probes adjacent buckets closest to it).
+        HASH_ARR particle_ids = this->family->probe_ids(particle, this->probes);
+
+        for (int i = 0; i < this->L; i++)
+        {
+            for (int p = 0; p <= this->probes; p++)
+            {
+                int bucket_size = 0;
+                uint64_t particle_id = particle_ids(i, p); // For each hash table and bucket, take the id,
+                const int *bucket_items =
+                    this->HT[i]->get_bucket_items(particle_id, bucket_size); // get the items from the bucket
+
+                for (int j = 0; j < bucket_size; j++)
+                {
+                    int bucket_particle_idx = bucket_items[j];
+
+                    if (particle_id != this->HT[i]->get_id(bucket_particle_idx) ||
+                        neighbours.visit(bucket_particle_idx) == false)
+                    { // and skip the items with a different id, or that were already
+                      // considered (found in a previous bucket).
+                        continue;
+                    }
 
-        delete neighbours;
-        neighbours = nullptr;
+                    auto bucket_particle = this->population.col(bucket_particle_idx).matrix();
 
-        return idx;
+                    if (this->in_box(bucket_particle, min_particle_radius, max_particle_radius))
+                    { // If the item is in the effective radius, add it to the list.
+                        neighbours.add_particle(bucket_particle_idx, bucket_particle);
+                    }
+                }
+            }
+        }
     }
 
   private:
-    int L; // Number of hash tables.
-    int N; // Number of nearest neighbours the algorithm returns.
-    Type err_goal;
-    Type effective_radius; // With the query particle as the center,
-                           // the algorithm creates a hypercube that
-                           // is a percentage of the size of the initial space
-                           // limits (dim_limits). If effective_radius = 1,
-                           // the initial limits (dim_limits) are used and
-                           // the query particle is not treated as the center.
-    Type_Arr dim_limits;   // The initial limits of the search space.
-
-    hash_table<Type, Type_Arr, Type_Vec> **HT;
+    int L;      // Number of hash tables.
+    int probes; // Number of adjacent buckets visited in every hash table (multi-probe LSH).
+
+    hash_family<Type, Type_Arr, Type_Vec> *family; // The hash functions of all the hash tables.
+    hash_table **HT;
 };
 
-#endif
\ No newline at end of file
+#endif
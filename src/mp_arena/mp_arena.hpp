@@ -0,0 +1,164 @@
+#ifndef __MPARENA__
+#define __MPARENA__
+
+#include <cstdlib>
+#include <new>
+
+#include "../local_definitions.hpp"
+
+class mp_arena
+{
+    // A rows x cols matrix of MPFR numbers of one precision, stored column-major
+    // like MPFR_ARR. The numbers and their limbs live in one block (MPFR custom
+    // interface), so the whole matrix costs one allocation instead of one per
+    // element. resize() keeps the block while it is large enough, so an arena
+    // that is reused as a workspace does not allocate in the steady state.
+    // The numbers are plain mpfr_ptr, they are computed with the in-place MPFR
+    // functions and exchanged with the MPFR arrays with load() and store().
+
+  public:
+    mp_arena()
+    {
+        this->block = nullptr;
+        this->numbers = nullptr;
+        this->n_rows = 0;
+        this->n_cols = 0;
+        this->capacity = 0;
+        this->prec = 0;
+    }
+
+    mp_arena(Eigen::Index rows, Eigen::Index cols, mpfr_prec_t prec = mpfr_get_default_prec()) : mp_arena()
+    {
+        this->resize(rows, cols, prec);
+    }
+
+    mp_arena(const mp_arena &) = delete;
+    mp_arena &operator=(const mp_arena &) = delete;
+
+    ~mp_arena()
+    {
+        std::free(this->block);
+    }
+
+    void resize(Eigen::Index rows, Eigen::Index cols, mpfr_prec_t prec = mpfr_get_default_prec())
+    {
+        // Resize the matrix. The numbers are set to zero.
+
+        Eigen::Index size = rows * cols;
+        size_t limb_size = mpfr_custom_get_size(prec);
+
+        if (size > this->capacity || prec != this->prec)
+        {
+            // The numbers first, then the limbs of every number.
+
+            void *block = std::malloc(size * (sizeof(__mpfr_struct) + limb_size) + 1);
+
+            if (block == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+
+            std::free(this->block);
+
+            this->block = block;
+            this->numbers = static_cast<__mpfr_struct *>(block);
+            this->capacity = size;
+            this->prec = prec;
+        }
+
+        char *limbs = reinterpret_cast<char *>(this->numbers + this->capacity);
+
+        for (Eigen::Index k = 0; k < size; k++)
+        {
+            mpfr_custom_init(limbs + k * limb_size, prec);
+            mpfr_custom_init_set(&this->numbers[k], MPFR_ZERO_KIND, 0, prec, limbs + k * limb_size);
+        }
+
+        this->n_rows = rows;
+        this->n_cols = cols;
+    }
+
+    inline mpfr_ptr operator()(Eigen::Index i, Eigen::Index j = 0)
+    {
+        return &this->numbers[i + j * this->n_rows];
+    }
+
+    inline mpfr_srcptr operator()(Eigen::Index i, Eigen::Index j = 0) const
+    {
+        return &this->numbers[i + j * this->n_rows];
+    }
+
+    inline Eigen::Index rows() const
+    {
+        return this->n_rows;
+    }
+
+    inline Eigen::Index cols() const
+    {
+        return this->n_cols;
+    }
+
+    inline mpfr_prec_t precision() const
+    {
+        return this->prec;
+    }
+
+    void load(const MPFR_ARR &arr)
+    {
+        // Copy an MPFR array (resizing the arena to it).
+
+        this->resize(arr.rows(), arr.cols(), this->prec != 0 ? this->prec : mpfr_get_default_prec());
+
+        for (Eigen::Index k = 0; k < arr.size(); k++)
+        {
+            mpfr_set(&this->numbers[k], arr(k).mpfr_srcptr(), MPFR_RNDN);
+        }
+    }
+
+    void store(MPFR_ARR &arr) const
+    {
+        // Copy the arena to an MPFR array. The existing elements of an array of
+        // the same size are assigned in place.
+
+        if (arr.rows() != this->n_rows || arr.cols() != this->n_cols)
+        {
+            arr = MPFR_ARR(this->n_rows, this->n_cols);
+        }
+
+        for (Eigen::Index k = 0; k < arr.size(); k++)
+        {
+            mpfr_set(arr(k).mpfr_ptr(), &this->numbers[k], MPFR_RNDN);
+        }
+    }
+
+  private:
+    void *block;             // The numbers and their limbs.
+    __mpfr_struct *numbers;  // The numbers (column-major).
+    Eigen::Index n_rows;
+    Eigen::Index n_cols;
+    Eigen::Index capacity;   // The number of numbers that fit in the block.
+    mpfr_prec_t prec;        // The precision of the numbers.
+};
+
+namespace lmath
+{ // In-place kernels of the MPFR phase, with the temporaries in an arena.
+
+inline void distance(mpfr_ptr d, const MP_REAL *x, const MP_REAL *y, int dim, mpfr_ptr tmp)
+{
+    // d = ||x - y|| (as (x - y).matrix().norm() computes it).
+
+    mpfr_set_zero(d, 1);
+
+    for (int k = 0; k < dim; k++)
+    {
+        mpfr_sub(tmp, x[k].mpfr_srcptr(), y[k].mpfr_srcptr(), MPFR_RNDN);
+        mpfr_sqr(tmp, tmp, MPFR_RNDN);
+        mpfr_add(d, d, tmp, MPFR_RNDN);
+    }
+
+    mpfr_sqrt(d, d, MPFR_RNDN);
+}
+
+} // namespace lmath
+
+#endif
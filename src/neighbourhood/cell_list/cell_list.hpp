@@ -0,0 +1,215 @@
+#ifndef __CELL__
+#define __CELL__
+
+#include <algorithm>
+#include <cmath>
+
+#include "../neighbourhood.hpp"
+
+template <typename Type, typename Type_Arr, typename Type_Vec>
+class cell_list : public neighbourhood<Type, Type_Arr, Type_Vec>
+{
+    // An exact index for low dimensions. The search space is split into a
+    // uniform grid of cells, half as wide as the search box, so a query scans
+    // at most 3 cells per dimension. The cells are stored flat (CSR layout,
+    // as the LSH hash tables): the particle indices sorted by cell and the
+    // offsets of the cells. The particles outside the search space are kept
+    // in the border cells.
+
+  public:
+    cell_list(Type effective_radius, const Type_Arr &dim_limits, const Type_Arr &population)
+        : neighbourhood<Type, Type_Arr, Type_Vec>(effective_radius, dim_limits, population)
+    {
+        int dim = population.rows();
+        int n = population.cols();
+
+        // The cells per dimension, with at most max_cells cells in the grid.
+        int cells = int(std::ceil(2 / double(effective_radius)));
+
+        if (std::pow(double(cells), dim) > max_cells)
+        {
+            cells = std::max(1, int(std::floor(std::pow(double(max_cells), 1.0 / dim))));
+        }
+
+        this->lower = std::vector<double>(dim);
+        this->width = std::vector<double>(dim);
+        this->cells = std::vector<int>(dim, cells);
+        this->stride = std::vector<int>(dim);
+
+        for (int k = 0, s = 1; k < dim; k++)
+        {
+            this->lower[k] = double(dim_limits(k, 0));
+            this->width[k] = double(dim_limits(k, 1) - dim_limits(k, 0)) / cells;
+            this->stride[k] = s;
+
+            s *= cells;
+        }
+
+        this->offsets = std::vector<int>(this->stride[dim - 1] * cells + 1);
+        this->indices = std::vector<int>(n);
+        this->cell_ids = std::vector<int>(n);
+
+        for (int i = 0; i < n; i++)
+        {
+            this->cell_ids[i] = this->cell_of(this->population.col(i));
+        }
+
+        this->sort();
+    }
+
+    void update(const Type_Arr &population) override
+    {
+        // Move the particles that moved to their new cells.
+
+        std::vector<int> moved = this->moved(population);
+
+        if (moved.size() == 0)
+        {
+            return;
+        }
+
+        for (int i : moved)
+        {
+            this->cell_ids[i] = this->cell_of(this->population.col(i));
+        }
+
+        this->sort();
+    }
+
+    void find(const Type_Vec &particle, priority_list<Type, Type_Vec> &neighbours) const override
+    {
+        // Collect the N closest particles in the search box of the particle,
+        // from the cells that the box overlaps.
+
+        int dim = int(this->cells.size());
+
+        neighbours.reset(particle);
+
+        Type_Vec max_particle_radius;
+        Type_Vec min_particle_radius;
+
+        this->search_box(particle, min_particle_radius, max_particle_radius);
+
+        std::vector<int> first(dim);
+        std::vector<int> last(dim);
+
+        for (int k = 0; k < dim; k++)
+        {
+            if (this->effective_radius == 1)
+            { // The whole search space.
+                first[k] = 0;
+                last[k] = this->cells[k] - 1;
+            }
+            else
+            {
+                first[k] = this->cell_coordinate(double(min_particle_radius(k)), k);
+                last[k] = this->cell_coordinate(double(max_particle_radius(k)), k);
+            }
+        }
+
+        // Visit the cells of the range in order (the first dimension changes fastest).
+        std::vector<int> c(first);
+
+        while (true)
+        {
+            int cell = 0;
+
+            for (int k = 0; k < dim; k++)
+            {
+                cell += c[k] * this->stride[k];
+            }
+
+            for (int j = this->offsets[cell]; j < this->offsets[cell + 1]; j++)
+            {
+                auto cell_particle = this->population.col(this->indices[j]).matrix();
+
+                if (this->in_box(cell_particle, min_particle_radius, max_particle_radius))
+                {
+                    neighbours.add_particle(this->indices[j], cell_particle);
+                }
+            }
+
+            int k = 0;
+
+            while (k < dim && c[k] == last[k])
+            {
+                c[k] = first[k];
+                k++;
+            }
+
+            if (k == dim)
+            {
+                break;
+            }
+
+            c[k]++;
+        }
+    }
+
+  private:
+    static constexpr double max_cells = 1 << 16; // The maximum number of cells in the grid.
+
+    std::vector<double> lower; // The lower limit of the grid in every dimension.
+    std::vector<double> width; // The width of the cells in every dimension.
+    std::vector<int> cells;    // The number of cells in every dimension.
+    std::vector<int> stride;   // The step of the cell id for every dimension.
+    std::vector<int> offsets;  // Where every cell begins in indices.
+    std::vector<int> indices;  // The particle indices, sorted by cell.
+    std::vector<int> cell_ids; // The cell of every particle.
+
+    inline int cell_coordinate(double x, int k) const
+    {
+        // The cell of a coordinate in dimension k (the border cell, if it is
+        // outside the grid).
+
+        double c = std::floor((x - this->lower[k]) / this->width[k]);
+
+        if (!(c > 0)) // (also if x is not a number)
+        {
+            return 0;
+        }
+
+        return int(std::min(c, double(this->cells[k] - 1)));
+    }
+
+    template <typename Derived> int cell_of(const Eigen::DenseBase<Derived> &x) const
+    {
+        int cell = 0;
+
+        for (int k = 0; k < int(this->cells.size()); k++)
+        {
+            cell += this->cell_coordinate(double(x(k)), k) * this->stride[k];
+        }
+
+        return cell;
+    }
+
+    void sort()
+    {
+        // Place the particles in their cells (counting sort on the cell of
+        // every particle).
+
+        int n = int(this->cell_ids.size());
+
+        std::fill(this->offsets.begin(), this->offsets.end(), 0);
+
+        for (int i = 0; i < n; i++)
+        {
+            this->offsets[this->cell_ids[i] + 1]++;
+        }
+
+        for (int b = 0; b + 1 < int(this->offsets.size()); b++)
+        {
+            this->offsets[b + 1] += this->offsets[b];
+        }
+
+        std::vector<int> next(this->offsets.begin(), this->offsets.end() - 1);
+
+        for (int i = 0; i < n; i++)
+        {
+            this->indices[next[this->cell_ids[i]]++] = i;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef __KDT__
+#define __KDT__
+
+#include <algorithm>
+
+#include "../neighbourhood.hpp"
+
+template <typename Type, typename Type_Arr, typename Type_Vec>
+class kd_tree : public neighbourhood<Type, Type_Arr, Type_Vec>
+{
+    // An exact index: a k-d tree over the particles. The tree is implicit in
+    // the order of the particle indices. A node is a range of the indices,
+    // split at its median particle in one dimension (the dimensions take
+    // turns with the depth). The lower half of the range holds the particles
+    // that are not greater in that dimension, the upper half the particles
+    // that are not smaller. A query skips the halves that are outside the
+    // search box, or farther than the farthest particle of a full list.
+
+  public:
+    kd_tree(Type effective_radius, const Type_Arr &dim_limits, const Type_Arr &population)
+        : neighbourhood<Type, Type_Arr, Type_Vec>(effective_radius, dim_limits, population)
+    {
+        this->indices = std::vector<int>(population.cols());
+
+        for (int i = 0; i < int(population.cols()); i++)
+        {
+            this->indices[i] = i;
+        }
+
+        this->build(0, int(this->indices.size()), 0);
+    }
+
+    void update(const Type_Arr &population) override
+    {
+        // Rebuild the tree, if any particle moved.
+
+        if (this->moved(population).size() > 0)
+        {
+            this->build(0, int(this->indices.size()), 0);
+        }
+    }
+
+    void find(const Type_Vec &particle, priority_list<Type, Type_Vec> &neighbours) const override
+    {
+        // Collect the N closest particles in the search box of the particle.
+
+        neighbours.reset(particle);
+
+        Type_Vec max_particle_radius;
+        Type_Vec min_particle_radius;
+
+        this->search_box(particle, min_particle_radius, max_particle_radius);
+        this->search(0, int(this->indices.size()), 0, particle, min_particle_radius, max_particle_radius, neighbours);
+    }
+
+  private:
+    static constexpr int leaf_size = 8; // The ranges up to this size are not split.
+
+    std::vector<int> indices; // The particle indices, in the order of the tree.
+
+    void build(int first, int last, int depth)
+    {
+        // Split the range [first, last) at its median in the dimension of
+        // the depth, and build the two halves.
+
+        if (last - first <= leaf_size)
+        {
+            return;
+        }
+
+        int mid = (first + last) / 2;
+        int d = depth % int(this->population.rows());
+
+        std::nth_element(this->indices.begin() + first, this->indices.begin() + mid, this->indices.begin() + last,
+                         [&](int a, int b) { return this->population(d, a) < this->population(d, b); });
+
+        this->build(first, mid, depth + 1);
+        this->build(mid + 1, last, depth + 1);
+    }
+
+    void search(int first, int last, int depth, const Type_Vec &particle, const Type_Vec &min_particle_radius,
+                const Type_Vec &max_particle_radius, priority_list<Type, Type_Vec> &neighbours) const
+    {
+        if (last - first <= leaf_size)
+        { // A leaf, check all of its particles.
+            for (int j = first; j < last; j++)
+            {
+                this->check(this->indices[j], min_particle_radius, max_particle_radius, neighbours);
+            }
+
+            return;
+        }
+
+        int mid = (first + last) / 2;
+        int d = depth % int(this->population.rows());
+        const Type &split = this->population(d, this->indices[mid]);
+
+        this->check(this->indices[mid], min_particle_radius, max_particle_radius, neighbours);
+
+        // The halves that can hold particles of the search box.
+        bool lower = (this->effective_radius == 1 || !(min_particle_radius(d) > split));
+        bool upper = (this->effective_radius == 1 || max_particle_radius(d) > split);
+
+        // Search the half of the particle first, the other half may then be
+        // farther than all the neighbours found.
+        bool lower_first = (particle(d) < split);
+
+        for (int h = 0; h < 2; h++)
+        {
+            bool is_lower = (lower_first == (h == 0));
+
+            if ((is_lower == true && lower == false) || (is_lower == false && upper == false))
+            {
+                continue;
+            }
+
+            if (h == 1 && neighbours.get_size() > 0 && neighbours.is_full() &&
+                lmath::abs(particle(d) - split) >= neighbours.get_farthest())
+            {
+                continue;
+            }
+
+            if (is_lower == true)
+            {
+                this->search(first, mid, depth + 1, particle, min_particle_radius, max_particle_radius, neighbours);
+            }
+            else
+            {
+                this->search(mid + 1, last, depth + 1, particle, min_particle_radius, max_particle_radius, neighbours);
+            }
+        }
+    }
+
+    inline void check(int i, const Type_Vec &min_particle_radius, const Type_Vec &max_particle_radius,
+                      priority_list<Type, Type_Vec> &neighbours) const
+    {
+        // Add a particle to the list, if it is in the search box.
+
+        auto tree_particle = this->population.col(i).matrix();
+
+        if (this->in_box(tree_particle, min_particle_radius, max_particle_radius))
+        {
+            neighbours.add_particle(i, tree_particle);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef __NBH__
+#define __NBH__
+
+#include <vector>
+
+#include "priority_list/priority_list.hpp"
+
+template <typename Type, typename Type_Arr, typename Type_Vec> class neighbourhood
+{
+    // The interface of the indices that find the neighbours of the particles
+    // (LSH, cell_list and kd_tree). An index is built on the population and
+    // updated when the particles move. A query collects the N closest
+    // particles (N = popsize / 4) that lie in the search box of a particle
+    // in a priority list. The queries only read the index. The local PSO
+    // uses the indices in double, for the MPFR and DD swarms on a double
+    // copy of the population.
+
+  public:
+    neighbourhood(Type effective_radius, const Type_Arr &dim_limits, const Type_Arr &population)
+    {
+        this->N = population.cols() / 4;
+        this->dim_limits = dim_limits;
+        this->effective_radius = effective_radius;
+        this->population = population;
+    }
+
+    virtual ~neighbourhood() {};
+
+    virtual void update(const Type_Arr &population) = 0;
+
+    virtual void find(const Type_Vec &particle, priority_list<Type, Type_Vec> &neighbours) const = 0;
+
+    Eigen::Vector<int, Eigen::Dynamic> find_idx(const Type_Vec &particle,
+                                                priority_list<Type, Type_Vec> &neighbours) const
+    {
+        this->find(particle, neighbours); // Find the N closest neighbours of the particle,
+
+        Eigen::Vector<int, Eigen::Dynamic> idx(neighbours.get_size()); // create an integer array and
+
+        for (int i = 0; i < neighbours.get_size(); i++)
+        {
+            idx(i) = neighbours.get_index(i); // save all the indices of the neighbours.
+        }
+
+        return idx;
+    }
+
+    inline int get_size() const
+    {
+        // The number of particles in the index.
+
+        return int(this->population.cols());
+    }
+
+    inline int get_neighbours() const
+    {
+        // The number of nearest neighbours a query returns (the capacity of
+        // its priority list).
+
+        return this->N;
+    }
+
+  protected:
+    int N;                 // Number of nearest neighbours the algorithm returns.
+    Type effective_radius; // With the query particle as the center,
+                           // the algorithm creates a hypercube that
+                           // is a percentage of the size of the initial space
+                           // limits (dim_limits). If effective_radius = 1,
+                           // the initial limits (dim_limits) are used and
+                           // the query particle is not treated as the center.
+    Type_Arr dim_limits;   // The initial limits of the search space.
+    Type_Arr population;   // The positions the index was built with
+                           // (the index holds only indices to it).
+
+    void search_box(const Type_Vec &particle, Type_Vec &min_particle_radius, Type_Vec &max_particle_radius) const
+    {
+        // If effective_radius < 1, then calculate the search space
+        // (the hypercube with the particle as the center).
+
+        if (this->effective_radius != 1)
+        {
+            Type_Vec max_dim_distance = Type_Vec(this->dim_limits.col(1) - this->dim_limits.col(0));
+            max_particle_radius = particle + ((this->effective_radius / 2) * max_dim_distance);
+            min_particle_radius = particle - ((this->effective_radius / 2) * max_dim_distance);
+        }
+    }
+
+    template <typename Derived>
+    inline bool in_box(const Eigen::MatrixBase<Derived> &x, const Type_Vec &min_particle_radius,
+                       const Type_Vec &max_particle_radius) const
+    {
+        // Returns true if the particle x is in the search space of a query.
+
+        return this->effective_radius == 1 ||
+               (x.array() >= min_particle_radius.array() && x.array() < max_particle_radius.array()).all();
+    }
+
+    std::vector<int> moved(const Type_Arr &population)
+    {
+        // Copy the particles that moved since the index was built (or last
+        // updated) and return their indices.
+
+        std::vector<int> idx;
+
+        for (int i = 0; i < int(population.cols()); i++)
+        {
+            if ((population.col(i) == this->population.col(i)).all() == false)
+            {
+                this->population.col(i) = population.col(i);
+                idx.push_back(i);
+            }
+        }
+
+        return idx;
+    }
+};
+
+#endif
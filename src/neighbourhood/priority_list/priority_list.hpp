@@ -0,0 +1,113 @@
+#ifndef __PRIO__
+#define __PRIO__
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "../../local_definitions.hpp"
+
+template <typename Type, typename Type_Vec> class priority_list
+{
+    // The closest neighbours of a query particle, sorted by their distance to
+    // it and bounded to a fixed capacity: when a particle is added to a full
+    // list, the farthest one is dropped. The list is scratch space that is
+    // reused by the queries (one list per thread). reset() starts a new query,
+    // and the particles seen by the query are stamped with its epoch, so that
+    // a particle found in several hash tables is considered only once.
+
+  public:
+    priority_list(int capacity, int popsize)
+    {
+        this->capacity = capacity;
+        this->epoch = 0;
+        this->stamps = std::vector<unsigned>(popsize, 0);
+        this->items.reserve(capacity + 1);
+    }
+
+    void reset(const Type_Vec &base_particle)
+    {
+        // Start a new query, around base_particle.
+
+        this->base_particle = base_particle;
+        this->items.clear();
+
+        if (++this->epoch == 0)
+        { // The epochs wrapped around, clear the stamps.
+            std::fill(this->stamps.begin(), this->stamps.end(), 0);
+            this->epoch = 1;
+        }
+    }
+
+    inline bool visit(int index)
+    {
+        // Returns false if the particle was already seen by the query.
+
+        if (this->stamps[index] == this->epoch)
+        {
+            return false;
+        }
+
+        this->stamps[index] = this->epoch;
+
+        return true;
+    }
+
+    template <typename Derived> void add_particle(int index, const Eigen::MatrixBase<Derived> &particle)
+    {
+        // To add a particle to the list, calculate its distance to the
+        // base_particle and insert it after the particles that are as close
+        // or closer. If the list is full, the farthest particle is dropped.
+
+        Type dist = (this->base_particle - particle).norm();
+
+        auto pos = std::upper_bound(this->items.begin(), this->items.end(), dist,
+                                    [](const Type &d, const std::pair<Type, int> &item) { return d < item.first; });
+
+        if (pos == this->items.end() && int(this->items.size()) >= this->capacity)
+        {
+            return; // It would be the farthest particle of a full list.
+        }
+
+        this->items.insert(pos, std::pair<Type, int>(dist, index));
+
+        if (int(this->items.size()) > this->capacity)
+        {
+            this->items.pop_back();
+        }
+    }
+
+    inline int get_size()
+    {
+        return int(this->items.size());
+    }
+
+    inline bool is_full()
+    {
+        return int(this->items.size()) >= this->capacity;
+    }
+
+    inline Type get_farthest()
+    {
+        // The distance of the farthest particle in the list.
+
+        return this->items.back().first;
+    }
+
+    inline int get_index(int i)
+    {
+        // The index of the i-th closest particle.
+
+        return this->items[i].second;
+    }
+
+  private:
+    int capacity;                            // The maximum number of particles in the list.
+    unsigned epoch;                          // The stamp of the current query.
+    std::vector<unsigned> stamps;            // The epoch of the last query that saw every particle.
+    std::vector<std::pair<Type, int>> items; // The distance and index of every particle, closest first.
+    Type_Vec base_particle;                  // The particle that the distances of all the
+                                             // other particles are measured from.
+};
+
+#endif
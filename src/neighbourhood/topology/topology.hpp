@@ -0,0 +1,135 @@
+#ifndef __TOPO__
+#define __TOPO__
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../../functions/functions.hpp"
+#include "../../local_definitions.hpp"
+
+class topology
+{
+    // A static neighbourhood: the neighbours (informants) of a particle are
+    // chosen by its index, not by its position, so they do not have to be
+    // searched for. Column r of the informants array holds the r-th informant
+    // of every particle, the first column the particles themselves.
+    //  - ring        : the previous and the next particle,
+    //  - von_neumann : the particles around it in a grid of ceil(sqrt(popsize))
+    //                  columns (the previous, the next, above and below),
+    //  - random      : a random k-regular graph, every particle has k informants
+    //                  and informs k particles. The particles are placed in a
+    //                  random order and inform the particles at k distinct
+    //                  random offsets in that order (a random circulant graph).
+    // The indices wrap around the population.
+
+  public:
+    topology(std::string type, int n, int k)
+    {
+        if (type == "ring")
+        {
+            this->informants = Eigen::Array<int, Eigen::Dynamic, Eigen::Dynamic>(n, 3);
+
+            for (int i = 0; i < n; i++)
+            {
+                this->informants(i, 0) = i;
+                this->informants(i, 1) = (i + n - 1) % n;
+                this->informants(i, 2) = (i + 1) % n;
+            }
+        }
+        else if (type == "von_neumann")
+        {
+            int cols = int(std::ceil(std::sqrt(double(n))));
+
+            this->informants = Eigen::Array<int, Eigen::Dynamic, Eigen::Dynamic>(n, 5);
+
+            for (int i = 0; i < n; i++)
+            {
+                this->informants(i, 0) = i;
+                this->informants(i, 1) = (i + n - 1) % n;
+                this->informants(i, 2) = (i + 1) % n;
+                this->informants(i, 3) = (i + n - cols) % n;
+                this->informants(i, 4) = (i + cols) % n;
+            }
+        }
+        else
+        {
+            k = std::min(k, n - 1); // (there are only n - 1 other particles)
+
+            // A random order of the particles and k distinct random offsets
+            // from 1 to n - 1 (partial Fisher-Yates shuffles).
+            std::vector<int> order(n);
+            std::vector<int> offsets(std::max(n - 1, 0));
+
+            for (int i = 0; i < n; i++)
+            {
+                order[i] = i;
+            }
+
+            for (int i = 0; i < n - 1; i++)
+            {
+                offsets[i] = i + 1;
+            }
+
+            for (int i = n - 1; i > 0; i--)
+            {
+                std::swap(order[i], order[uniform_int(0, i)]);
+            }
+
+            for (int r = 0; r < k; r++)
+            {
+                std::swap(offsets[r], offsets[uniform_int(r, n - 2)]);
+            }
+
+            this->informants = Eigen::Array<int, Eigen::Dynamic, Eigen::Dynamic>(n, 1 + k);
+
+            for (int i = 0; i < n; i++)
+            {
+                this->informants(order[i], 0) = order[i];
+
+                for (int r = 1; r <= k; r++)
+                {
+                    this->informants(order[i], r) = order[(i + offsets[r - 1]) % n];
+                }
+            }
+        }
+    }
+
+    inline int get_size() const
+    {
+        // The number of particles in the topology.
+
+        return int(this->informants.rows());
+    }
+
+    template <typename Type_Vec>
+    void best_informants(const Type_Vec &fbestpos, Eigen::Vector<int, Eigen::Dynamic> &best) const
+    {
+        // Save the index of the best informant of every particle (the lowest
+        // best value, the particle itself on ties) in best, one column of
+        // informants at a time.
+
+        int n = this->get_size();
+
+        best = this->informants.col(0);
+
+        for (int r = 1; r < int(this->informants.cols()); r++)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                int j = this->informants(i, r);
+
+                if (fbestpos(j) < fbestpos(best(i)))
+                {
+                    best(i) = j;
+                }
+            }
+        }
+    }
+
+  private:
+    Eigen::Array<int, Eigen::Dynamic, Eigen::Dynamic> informants; // The informants of every particle (one per column).
+};
+
+#endif
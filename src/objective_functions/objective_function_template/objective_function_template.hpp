@@ -44,7 +44,7 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         // Objective_function->calculate() -> calculate(_,false);
     }
 
-    Type_Vec objective_function(Type_Arr population)
+    Type_Vec objective_function(const Type_Arr &population)
     {
         // This function should call this->calculate(_,true) for
         // every particle and measure the loss for each particle
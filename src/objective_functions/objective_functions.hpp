@@ -10,7 +10,7 @@ template <typename Type> struct obj_params
     // template_params<Type,Type_Arr,Type_Vec,Type_Empty> temp;
 };
 
-template <typename Type> obj_params<MP_REAL> obj_params_to_mpfr(obj_params<Type> params)
+template <typename Type> obj_params<MP_REAL> obj_params_to_mpfr(const obj_params<Type> &params)
 {
     obj_params<MP_REAL> mpfr_params;
 
@@ -31,7 +31,7 @@ template <typename Type> obj_params<MP_REAL> obj_params_to_mpfr(obj_params<Type>
     return mpfr_params;
 }
 
-template <typename Type> obj_params<double> obj_params_to_double(obj_params<Type> params)
+template <typename Type> obj_params<double> obj_params_to_double(const obj_params<Type> &params)
 {
     obj_params<double> double_params;
 
@@ -52,6 +52,27 @@ template <typename Type> obj_params<double> obj_params_to_double(obj_params<Type
     return double_params;
 }
 
+template <typename Type> obj_params<DD_REAL> obj_params_to_dd(const obj_params<Type> &params)
+{
+    obj_params<DD_REAL> dd_params;
+
+    dd_params.pc.p = params.pc.p;
+    dd_params.pc.threads = params.pc.threads;
+    dd_params.pc.c1 = DD_REAL(params.pc.c1);
+    dd_params.pc.c2 = DD_REAL(params.pc.c2);
+    dd_params.pc.c3 = DD_REAL(params.pc.c3);
+    dd_params.pc.dt = DD_REAL(params.pc.dt);
+    dd_params.pc.ene = DD_REAL(params.pc.ene);
+    dd_params.pc.xpoin = DD_REAL(params.pc.xpoin);
+    dd_params.pc.err_goal = DD_REAL(params.pc.err_goal);
+
+    /*
+    Conversions for template parameters.
+    */
+
+    return dd_params;
+}
+
 template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Empty> class Objective_Functions
 {
   public:
@@ -125,7 +146,7 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         */
     }
 
-    Type_Vec call(Type_Arr popul)
+    Type_Vec call(const Type_Arr &popul)
     {
         // A function that calls the objective function in use.
 
@@ -150,6 +171,98 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         }
     }
 
+    int get_threads()
+    {
+        // The number of threads the objective function is evaluated with.
+
+        if (this->poincare != nullptr)
+        {
+            return this->poincare->get_threads();
+        }
+        else if (this->s_poincare != nullptr)
+        {
+            return this->s_poincare->get_threads();
+        }
+
+        return 1;
+    }
+
+    void set_threads(int threads)
+    {
+        // Set the number of threads the objective function is evaluated with.
+
+        if (this->poincare != nullptr)
+        {
+            this->poincare->set_threads(threads);
+        }
+        else if (this->s_poincare != nullptr)
+        {
+            this->s_poincare->set_threads(threads);
+        }
+    }
+
+    void set_buffered(bool buffered)
+    {
+        // Keep the error messages of the evaluations in a buffer (true) or
+        // write them to the output (false).
+
+        if (this->poincare != nullptr)
+        {
+            this->poincare->set_buffered(buffered);
+        }
+        else if (this->s_poincare != nullptr)
+        {
+            this->s_poincare->set_buffered(buffered);
+        }
+    }
+
+    std::string take_messages()
+    {
+        // Return and clear the buffered error messages.
+
+        if (this->poincare != nullptr)
+        {
+            return this->poincare->take_messages();
+        }
+        else if (this->s_poincare != nullptr)
+        {
+            return this->s_poincare->take_messages();
+        }
+
+        return "";
+    }
+
+    void set_tolerance(const Type &tolerance)
+    {
+        // Request coarse evaluations, with this ODE tolerance (0: full accuracy).
+
+        if (this->poincare != nullptr)
+        {
+            this->poincare->set_tolerance(tolerance);
+        }
+        else if (this->s_poincare != nullptr)
+        {
+            this->s_poincare->set_tolerance(tolerance);
+        }
+    }
+
+    bool refine(Type_Vec &particle, int steps)
+    {
+        // Polish a particle with Newton steps, if the objective function
+        // supports them. Returns true if the particle was moved.
+
+        if (this->poincare != nullptr)
+        {
+            return this->poincare->newton(particle, steps);
+        }
+        else if (this->s_poincare != nullptr)
+        {
+            return this->s_poincare->newton(particle, steps);
+        }
+
+        return false;
+    }
+
     Type_Arr calculate(Type_Vec particle)
     {
         // A function that calculates the new position of only one particle of the population.
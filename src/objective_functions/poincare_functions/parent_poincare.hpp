@@ -2,6 +2,7 @@
 #define __PPNC__
 
 #include "../../odepack/include/odepack/ode.hpp"
+#include <sstream>
 #include <thread>
 
 #ifdef __MAC__
@@ -50,6 +51,33 @@ template <typename T> void F(T *res, const T &t, const T *q, const T *args, cons
     res[3] = -vy;
 };
 
+template <typename T> void F_variational(T *res, const T &t, const T *q, const T *args, const void *aux)
+{
+    // F together with its linearization, for the position q[0..3] and two
+    // tangent vectors q[4..7] and q[8..11] (the jacobian of the section map).
+    const auto *pc = reinterpret_cast<const poinc_params<T> *>(aux);
+
+    F(res, t, q, args, aux);
+
+    const T &x = q[0];
+    const T &y = q[1];
+
+    // The hessian of the potential.
+    T vxx = 2 * pc->c1 - 12 * pc->c3 * lmath::pow(x, 2) + 12 * pc->c3 * lmath::pow(y, 2);
+    T vxy = 24 * pc->c3 * x * y;
+    T vyy = 2 * pc->c1 - 12 * pc->c3 * lmath::pow(y, 2) + 12 * pc->c3 * lmath::pow(x, 2);
+
+    for (int k = 4; k < 12; k += 4)
+    {
+        const T *d = q + k;
+
+        res[k] = d[2];
+        res[k + 1] = d[3];
+        res[k + 2] = -(vxx * d[0] + vxy * d[1]);
+        res[k + 3] = -(vxy * d[0] + vyy * d[1]);
+    }
+}
+
 template <typename T> T _event(const T &t, const T *q, const T *args, const void *aux)
 {
     // The event function, it is true when it is close to 0 (meaning y ~= x_poin).
@@ -137,6 +165,55 @@ template <typename Type, typename Type_Arr, typename Type_Vec> class Parent_Poin
         }
     }
 
+    inline int get_threads()
+    {
+        return this->pc.threads;
+    }
+
+    inline void set_threads(int threads)
+    {
+        this->pc.threads = threads;
+    }
+
+    void set_buffered(bool buffered)
+    {
+        // Keep the error messages of the evaluations in a buffer instead of
+        // writing them to the output, while other threads may write to it
+        // (the asynchronous PSO). take_messages() returns them.
+
+        this->buffered = buffered;
+    }
+
+    std::string take_messages()
+    {
+        // Return and clear the buffered error messages.
+
+        std::string messages;
+#ifdef __MAC__
+        dispatch_semaphore_wait(this->sem_lock, DISPATCH_TIME_FOREVER);
+
+        messages = this->messages.str();
+        this->messages.str("");
+
+        dispatch_semaphore_signal(this->sem_lock);
+#else
+        std::lock_guard<std::mutex> lock(this->mutex_lock);
+
+        messages = this->messages.str();
+        this->messages.str("");
+#endif
+        return messages;
+    }
+
+    void set_tolerance(const Type &tolerance)
+    {
+        // The relative tolerance of the ODE integration of the next evaluations.
+        // It is never tighter than the full accuracy (1e-4 * err_goal), so 0
+        // restores the full accuracy.
+
+        this->tolerance = tolerance;
+    }
+
     Type_Arr calculate(Type_Vec particle, Type_Vec &q, bool first_only)
     {
         q[0] = particle(0);
@@ -164,6 +241,11 @@ template <typename Type, typename Type_Arr, typename Type_Vec> class Parent_Poin
         Type min_step = 0;
         constexpr size_t N = 4;
 
+        if (this->tolerance > rtol)
+        { // A coarse evaluation (see set_tolerance()).
+            rtol = this->tolerance;
+        }
+
         StopEvent<Type> stop_events("poincare_stop", _stop_event<Type>, this);
         PreciseEvent<Type, N> events("poincare_sect", _event<Type>, 1, nullptr, false, 1e-20, &(this->pc));
 
@@ -225,9 +307,72 @@ template <typename Type, typename Type_Arr, typename Type_Vec> class Parent_Poin
         }
     }
 
+    bool newton(Type_Vec &particle, int steps)
+    {
+        // Polish a particle that is close to a periodic orbit with damped
+        // Newton (Levenberg-Marquardt) steps on the fixed point of the section
+        // map, z = P(z) with z = (x, px). A step is accepted only if it reduces
+        // the residual, otherwise the damping is increased. Returns true if the
+        // particle was moved.
+
+        Type G[2], A[4];
+        Type G_trial[2], A_trial[4];
+        Type lambda = Type(1e-3);
+        bool moved = false;
+
+        if (particle.size() != 2 || this->section_map(particle, G, A) == false)
+        {
+            return false;
+        }
+
+        Type residual = G[0] * G[0] + G[1] * G[1];
+
+        for (int it = 0; it < steps && residual > 0 && lambda < Type(1e8); it++)
+        {
+            // Solve (A^T A + lambda diag(A^T A)) dz = -A^T G.
+            Type m00 = (A[0] * A[0] + A[2] * A[2]) * (Type(1) + lambda);
+            Type m01 = A[0] * A[1] + A[2] * A[3];
+            Type m11 = (A[1] * A[1] + A[3] * A[3]) * (Type(1) + lambda);
+            Type b0 = -(A[0] * G[0] + A[2] * G[1]);
+            Type b1 = -(A[1] * G[0] + A[3] * G[1]);
+            Type det = m00 * m11 - m01 * m01;
+
+            if (det == 0)
+            {
+                break;
+            }
+
+            Type_Vec trial = particle;
+
+            trial(0) += (m11 * b0 - m01 * b1) / det;
+            trial(1) += (m00 * b1 - m01 * b0) / det;
+
+            if (this->section_map(trial, G_trial, A_trial) == true &&
+                G_trial[0] * G_trial[0] + G_trial[1] * G_trial[1] < residual)
+            {
+                particle = trial;
+                residual = G_trial[0] * G_trial[0] + G_trial[1] * G_trial[1];
+                lambda = lambda / 10;
+                moved = true;
+
+                std::copy(G_trial, G_trial + 2, G);
+                std::copy(A_trial, A_trial + 4, A);
+            }
+            else
+            {
+                lambda = lambda * 10;
+            }
+        }
+
+        return moved;
+    }
+
   protected:
     std::ostream *output;
     poinc_params<Type> pc;
+    Type tolerance = 0;          // The requested ODE tolerance (0: full accuracy).
+    bool buffered = false;       // If true, the error messages are kept in messages.
+    std::ostringstream messages; // The buffered error messages.
 #ifdef __MAC__
     dispatch_semaphore_t sem_lock;
 #else
@@ -245,6 +390,19 @@ template <typename Type, typename Type_Arr, typename Type_Vec> class Parent_Poin
 #endif
     }
 
+    std::ostream &message_output()
+    {
+        // Where the error messages of the evaluations are written (called
+        // with the lock held).
+
+        if (this->buffered == true)
+        {
+            return this->messages;
+        }
+
+        return *this->output;
+    }
+
     bool check_energy(Type *q)
     {
         Type x = q[0];
@@ -267,11 +425,11 @@ template <typename Type, typename Type_Arr, typename Type_Vec> class Parent_Poin
 
             if (YY1 < 0)
             {
-                (*this->output) << "~> Error: The initial energy is not constant" << std::endl;
+                this->message_output() << "~> Error: The initial energy is not constant" << std::endl;
             }
             else
             {
-                (*this->output) << "~> Error: The initial energy is not constant (=0)" << std::endl;
+                this->message_output() << "~> Error: The initial energy is not constant (=0)" << std::endl;
             }
 
             dispatch_semaphore_signal(this->sem_lock);
@@ -285,11 +443,11 @@ template <typename Type, typename Type_Arr, typename Type_Vec> class Parent_Poin
 
             if (YY1 < 0)
             {
-                (*this->output) << "~> Error: The initial energy is not constant" << std::endl;
+                this->message_output() << "~> Error: The initial energy is not constant" << std::endl;
             }
             else
             {
-                (*this->output) << "~> Error: The initial energy is not constant (=0)" << std::endl;
+                this->message_output() << "~> Error: The initial energy is not constant (=0)" << std::endl;
             }
 
             return false;
@@ -297,6 +455,85 @@ template <typename Type, typename Type_Arr, typename Type_Vec> class Parent_Poin
 #endif
     }
 
+    bool section_map(const Type_Vec &z, Type *G, Type *A)
+    {
+        // The residual G = P(z) - z of the section map P (pc.p crossings of the
+        // section) at z = (x, px), and its jacobian A = DP - I (row-major). The
+        // jacobian is integrated with the variational equations, for the
+        // tangent vectors of x and px on the energy surface.
+
+        constexpr size_t N = 12;
+
+        Type q[N];
+        Type f[4];
+        Type t0 = 0;
+        Type atol = 0;
+        Type rtol = Type(1e-4) * this->pc.err_goal;
+        Type min_step = 0;
+        Type YY1 = 2 * (this->pc.ene - this->V(z(0), this->pc.xpoin)) - lmath::pow(z(1), 2);
+
+        if (!(YY1 > 0))
+        {
+            return false;
+        }
+
+        q[0] = z(0);
+        q[1] = this->pc.xpoin;
+        q[2] = z(1);
+        q[3] = lmath::sqrt(YY1);
+
+        // On the energy surface, py * dpy = -V_x * dx - px * dpx.
+        F<Type>(f, t0, q, nullptr, &(this->pc));
+
+        for (size_t i = 4; i < N; i++)
+        {
+            q[i] = 0;
+        }
+
+        q[4] = 1;
+        q[7] = f[2] / q[3];
+        q[10] = 1;
+        q[11] = -q[2] / q[3];
+
+        PreciseEvent<Type, N> events("poincare_sect", _event<Type>, 1, nullptr, false, 1e-20, &(this->pc));
+
+        Array1D<Type, N> q0(q);
+        ODE<Type, N> ode({F_variational, nullptr, &(this->pc)}, t0, q0, rtol, atol, min_step, inf<Type>(),
+                         this->pc.dt, 1, {}, {&events}, "RK45");
+        OdeResult<Type, N> ode_results = ode.integrate(1000, 0, {{"poincare_sect", this->pc.p, true}});
+
+        if (ode_results.success() == false || ode_results.q().Nrows() < size_t(this->pc.p))
+        {
+            return false;
+        }
+
+        size_t Nres = ode_results.q().Nrows();
+
+        for (size_t j = 0; j < N; j++)
+        {
+            q[j] = ode_results.q(Nres - 1, j);
+        }
+
+        F<Type>(f, t0, q, nullptr, &(this->pc));
+
+        for (int i = 0; i < 2; i++)
+        {
+            // The crossing time moves with the tangent vector, dT = -dy / (dy/dt).
+            const Type *d = q + 4 + 4 * i;
+            Type dT = -d[1] / f[1];
+
+            A[i] = d[0] + f[0] * dT;
+            A[2 + i] = d[2] + f[2] * dT;
+        }
+
+        A[0] -= 1;
+        A[3] -= 1;
+        G[0] = q[0] - z(0);
+        G[1] = q[2] - z(1);
+
+        return true;
+    }
+
     Type V(Type x, Type y) const
     {
         return this->pc.c1 * (lmath::pow(x, 2) + lmath::pow(y, 2)) + this->pc.c2 * y -
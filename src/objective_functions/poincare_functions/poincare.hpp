@@ -17,7 +17,7 @@ class Poincare : public Parent_Poincare<Type, Type_Arr, Type_Vec>
 #endif
     }
 
-    Type_Vec objective_function(Type_Arr population)
+    Type_Vec objective_function(const Type_Arr &population)
     {
         Type_Vec fpopulation(population.cols());
 #ifdef __MAC__
@@ -69,7 +69,7 @@ class Poincare : public Parent_Poincare<Type, Type_Arr, Type_Vec>
         int i; // The number of particle that is being processed.
         Poincare *instance;
         Type_Vec *fpopulation;
-        const Type_Arr population;
+        const Type_Arr &population; // Alive until all the particles are evaluated.
     };
 
     static void objf_calculation(void *instance)
@@ -6,6 +6,7 @@
 #include <chrono>
 #include <mpreal.h>
 #include <omp.h>
+#include "../../../dd_real/dd_real.hpp"
 #include "../ndspan/arrays.hpp"
 
 #define DEFAULT_RULE_OF_FOUR(CLASSNAME)                  \
@@ -121,6 +122,11 @@ inline bool is_finite(const mpfr::mpreal& value) {
     return mpfr_number_p(value.mpfr_ptr()) != 0;
 }
 
+template <>
+inline bool is_finite(const dd_real& value) {
+    return isfinite(value);
+}
+
 template<typename T>
 T rms_norm(const T* x, size_t size){
     return sqrt(norm_squared(x, size)/size);
@@ -0,0 +1,216 @@
+#include <filesystem>
+
+#include "batch.hpp"
+
+Batch::Batch(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL> &ep, int swarms, double swap_point,
+             int precision, std::string type, bool constriction, std::ostream *output)
+{
+    this->swarms = swarms;
+    this->swap_point = swap_point;
+    this->seed = p.seed;
+    this->stream = p.stream;
+    this->async_threads = p.async_threads;
+    this->elite = p.elite;
+    this->checkpoint = p.checkpoint;
+    this->dd_tier = p.dd_tier;
+    this->dd_swap_point = p.dd_swap_point;
+    this->type = type;
+
+    if (this->type != "Global_Classic" && this->type != "Local_Classic")
+    {
+        std::cout << "~> Error: Please select a correct type. [Global_Classic] or [Local_Classic]." << std::endl;
+
+        this->initialized = false;
+
+        return;
+    }
+
+    for (int k = 0; k < this->swarms; k++)
+    {
+        pso_params<MP_REAL, MPFR_ARR> swarm_p = p;
+
+        swarm_p.stream = p.stream + k; // Every swarm draws from its own random stream.
+
+        if (p.tp.file != "")
+        { // Every swarm writes its records to its own file (e.g. run.csv -> run_0.csv).
+            std::filesystem::path file(p.tp.file);
+
+            swarm_p.tp.file =
+                (file.parent_path() / (file.stem().string() + "_" + std::to_string(k) + file.extension().string()))
+                    .string();
+        }
+
+        // Initialize the MPFR and Double models of the swarm.
+
+        if (this->type == "Global_Classic")
+        {
+            this->batch_in_mpreal.push_back(
+                new Global_Classic_Internal<MP_REAL, MPFR_ARR, MPFR_VEC, MPFR_EMPTY>(swarm_p, "mp_real", precision,
+                                                                                     output));
+            this->batch_in_double.push_back(new Global_Classic_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY>(
+                pso_params_to_double(swarm_p), "double", precision, output));
+        }
+        else
+        {
+            this->batch_in_mpreal.push_back(new Local_Classic_Internal<MP_REAL, MPFR_ARR, MPFR_VEC, MPFR_EMPTY>(
+                swarm_p, ep, "mp_real", precision, constriction, output));
+            this->batch_in_double.push_back(new Local_Classic_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY>(
+                pso_params_to_double(swarm_p), enhanced_params_to_double(ep), "double", precision, constriction,
+                output));
+        }
+    }
+
+    this->initialized = this->parameter_check();
+}
+
+Batch::~Batch()
+{
+    for (int k = 0; k < int(this->batch_in_double.size()); k++)
+    {
+        delete this->batch_in_double[k];
+        delete this->batch_in_mpreal[k];
+    }
+
+    this->batch_in_double.clear();
+    this->batch_in_mpreal.clear();
+}
+
+bool Batch::parameter_check()
+{
+    if (this->swarms < 1)
+    {
+        std::cout << "~> Error: The batch should contain at least one swarm." << std::endl;
+
+        return false;
+    }
+    else if (this->batch_in_mpreal[0]->parameter_check() == false)
+    {
+        return false;
+    }
+    else if (this->async_threads > 0)
+    {
+        std::cout << "~> Error: The swarms of a batch cannot run asynchronously." << std::endl;
+
+        return false;
+    }
+    else if (this->checkpoint != "")
+    {
+        std::cout << "~> Error: The swarms of a batch cannot be checkpointed." << std::endl;
+
+        return false;
+    }
+    else if (this->dd_tier == true || this->dd_swap_point != 0)
+    {
+        std::cout << "~> Error: The swarms of a batch cannot use the double-double tier." << std::endl;
+
+        return false;
+    }
+
+    return true;
+}
+
+void Batch::set_Obj_F(std::string objective_func, const obj_params<MP_REAL> &params)
+{
+    // Set the objective functions for all the models.
+
+    for (int k = 0; k < this->swarms; k++)
+    {
+        this->batch_in_mpreal[k]->set_Obj_F(objective_func, params);
+        this->batch_in_double[k]->set_Obj_F(objective_func, obj_params_to_double(params));
+    }
+}
+
+std::vector<MPFR_ARR> Batch::fit()
+{
+    std::vector<MPFR_ARR> results(this->swarms);
+    std::vector<DOUBLE_ARR> double_results;
+    std::vector<MPFR_ARR> mpreal_results;
+
+    std::vector<xoshiro256> engines;         // The random engines of the swarms.
+    std::vector<xoshiro256> refine_engines;  // The random engines of the swarms that continue in mpreal.
+    std::vector<int> refine;                 // The swarms that continue in mpreal.
+    std::vector<PSO<MP_REAL, MPFR_ARR, MPFR_VEC, MPFR_EMPTY> *> refine_in_mpreal;
+
+    for (int k = 0; k < this->swarms; k++)
+    { // Empty the files of the telemetry records of the swarms.
+        this->batch_in_double[k]->clear_telemetry();
+    }
+
+    if (this->seed != 0)
+    {
+        // Seed the engine of every swarm, so that the runs are reproducible.
+
+        for (int k = 0; k < this->swarms; k++)
+        {
+            engines.push_back(xoshiro256(this->seed, this->stream + k));
+        }
+    }
+
+    // Run all the swarms up until the swap point.
+    Batch_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY> double_batch(this->batch_in_double,
+                                                                              (this->seed != 0) ? &engines : nullptr);
+
+    double_results = double_batch.fit(this->swap_point);
+
+    for (int k = 0; k < this->swarms; k++)
+    {
+        if (double_results[k].size() > 0 || this->batch_in_double[k]->get_status() == "stagnated")
+        {
+            // If a minimum is found (or the swarm stagnated), the swarm is done.
+
+            results[k] = double_to_mpfr_ARR(double_results[k]);
+        }
+        else
+        {
+            // Import the variables from the double model to the mpreal model.
+            variables v = this->batch_in_double[k]->var_export();
+
+            select_elite(v, this->elite);
+            this->batch_in_mpreal[k]->var_import(std::move(v));
+
+            refine.push_back(k);
+            refine_in_mpreal.push_back(this->batch_in_mpreal[k]);
+
+            if (this->seed != 0)
+            {
+                refine_engines.push_back(engines[k]);
+            }
+        }
+    }
+
+    if (refine.size() == 0)
+    {
+        return results;
+    }
+
+    // Run the rest of the swarms from the swap point until they converge or
+    // reach maximum iterations.
+    Batch_Internal<MP_REAL, MPFR_ARR, MPFR_VEC, MPFR_EMPTY> mpreal_batch(
+        refine_in_mpreal, (this->seed != 0) ? &refine_engines : nullptr);
+
+    mpreal_results = mpreal_batch.fit(this->swap_point);
+
+    for (int k = 0; k < int(refine.size()); k++)
+    {
+        results[refine[k]] = mpreal_results[k];
+    }
+
+    return results;
+}
+
+Batch *Batch_Init(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL> &ep, int swarms, double swap_point,
+                  int precision, std::string type, bool constriction, std::ostream *output)
+{
+    // A function that initializes the batch of swarms and checks that the
+    // parameters are logically correct.
+
+    Batch *pso = new Batch(p, ep, swarms, swap_point, precision, type, constriction, output);
+
+    if (pso->is_initialized() == false)
+    {
+        delete pso;
+        pso = nullptr;
+    }
+
+    return pso;
+}
@@ -0,0 +1,60 @@
+#ifndef __BATCH__
+#define __BATCH__
+
+#include "../enhanced/local_classic/local_classic_internal.hpp"
+#include "../global_classic/global_classic_internal.hpp"
+#include "batch_internal.hpp"
+
+class Batch
+{
+    // Runs a number of independent Global_Classic or Local_Classic swarms in lockstep,
+    // with one evaluation of the objective function per iteration for all the swarms.
+    // Swarm k uses the random stream p.stream + k, so it returns the same result as a
+    // separate fit() with that stream.
+
+  public:
+    Batch(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL> &ep, int swarms, double swap_point,
+          int precision = 64, std::string type = "Global_Classic", bool constriction = false,
+          std::ostream *output = &(std::cout));
+    ~Batch();
+
+    bool is_initialized();
+    bool parameter_check();
+
+    void print_params();
+    void set_Obj_F(std::string objective_func, const obj_params<MP_REAL> &params);
+
+    std::vector<MPFR_ARR> fit();
+
+  private:
+    bool initialized;
+    int swarms;
+    int async_threads;
+    double swap_point;
+    uint64_t seed;
+    uint64_t stream;
+    int elite;              // The particles of a swarm that continue in mpreal (0: the whole swarm).
+    std::string checkpoint; // Not supported by the batch (must be empty).
+    bool dd_tier;           // Not supported by the batch (must be off),
+    double dd_swap_point;   // only double and mpreal swarms are built.
+    std::string type;
+
+    std::vector<PSO<MP_REAL, MPFR_ARR, MPFR_VEC, MPFR_EMPTY> *> batch_in_mpreal;
+    std::vector<PSO<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY> *> batch_in_double;
+};
+
+inline bool Batch::is_initialized()
+{
+    return this->initialized;
+};
+
+inline void Batch::print_params()
+{
+    this->batch_in_mpreal[0]->print_params();
+}
+
+Batch *Batch_Init(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL> &ep, int swarms, double swap_point,
+                  int precision = 64, std::string type = "Global_Classic", bool constriction = false,
+                  std::ostream *output = &(std::cout));
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef __BATCHI__
+#define __BATCHI__
+
+#include "../pso.hpp"
+
+template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Empty> class Batch_Internal
+{
+    // Advances a number of independent swarms in lockstep. In every iteration,
+    // the populations of the running swarms are concatenated and evaluated
+    // with one call of the objective function, so that it receives one large
+    // parallel workload instead of one small workload per swarm.
+    // Every swarm keeps its own random engine (if the runs are seeded), so each
+    // swarm follows exactly the same path as a separate fit().
+
+  public:
+    Batch_Internal(std::vector<PSO<Type, Type_Arr, Type_Vec, Type_Empty> *> swarms,
+                   std::vector<xoshiro256> *engines = nullptr)
+    {
+        this->swarms = swarms;
+        this->engines = engines;
+    };
+
+    std::vector<Type_Arr> fit(double swap_point)
+    {
+        int n = this->swarms.size();
+        std::vector<bool> running(n, false);
+        std::vector<bool> success(n, false);
+        std::vector<bool> evolved(n, false);
+        std::vector<double> swap_points(n, swap_point);
+        std::vector<Type_Arr> results(n);
+
+        for (int k = 0; k < n; k++)
+        {
+            this->select_engine(k);
+            running[k] = this->swarms[k]->fit_begin(swap_points[k]);
+            this->select_engine(k);
+
+            if (running[k] == true)
+            {
+                this->swarms[k]->prepare_evaluation("initial");
+            }
+        }
+
+        this->evaluate(running, "initial");
+
+        for (int k = 0; k < n; k++)
+        {
+            if (running[k] == true)
+            {
+                running[k] = this->swarms[k]->fit_initial_check();
+            }
+
+            if (running[k] == true)
+            {
+                this->swarms[k]->begin_evolution();
+                evolved[k] = true;
+            }
+            else
+            {
+                results[k] = this->swarms[k]->result;
+            }
+        }
+
+        // The evolution loop of the batch. A swarm leaves the batch
+        // when it converges, reaches the swap point or maximum iterations.
+        while (true)
+        {
+            bool any = false;
+
+            for (int k = 0; k < n; k++)
+            {
+                if (running[k] == true)
+                {
+                    running[k] = this->swarms[k]->evolution_running(success[k], swap_points[k]);
+                }
+
+                if (running[k] == true)
+                {
+                    this->select_engine(k);
+                    this->swarms[k]->advance_swarm();
+                    this->select_engine(k);
+
+                    any = true;
+                }
+            }
+
+            if (any == false)
+            {
+                break;
+            }
+
+            this->evaluate(running);
+
+            for (int k = 0; k < n; k++)
+            {
+                if (running[k] == true)
+                {
+                    bool done = success[k];
+
+                    this->select_engine(k);
+                    this->swarms[k]->finish_iteration(done);
+                    this->select_engine(k);
+
+                    success[k] = done;
+                }
+            }
+        }
+
+        for (int k = 0; k < n; k++)
+        {
+            if (evolved[k] == false)
+            {
+                continue;
+            }
+
+            if (this->swarms[k]->status != "swap")
+            {
+                this->swarms[k]->end_evolution(success[k]);
+            }
+
+            results[k] = this->swarms[k]->fit_end(success[k], swap_points[k]);
+        }
+
+        return results;
+    }
+
+  private:
+    std::vector<PSO<Type, Type_Arr, Type_Vec, Type_Empty> *> swarms;
+    std::vector<xoshiro256> *engines; // The random engines of the swarms (nullptr if not seeded).
+
+    inline void select_engine(int k)
+    {
+        // Swap the random engine of the thread with the engine of swarm k.
+        // Calling it again restores both engines.
+
+        if (this->engines != nullptr)
+        {
+            std::swap(rng(), (*this->engines)[k]);
+        }
+    }
+
+    void evaluate(const std::vector<bool> &running, std::string type = "")
+    {
+        // Evaluate the populations of the running swarms in one batch.
+
+        int cols = 0;
+        int first = -1;
+
+        for (int k = 0; k < int(this->swarms.size()); k++)
+        {
+            if (running[k] == true)
+            {
+                cols += this->swarms[k]->popul.cols();
+                first = (first == -1) ? k : first;
+            }
+        }
+
+        if (first == -1)
+        {
+            return;
+        }
+
+        Type_Arr batch(this->swarms[first]->popul.rows(), cols);
+
+        cols = 0;
+
+        for (int k = 0; k < int(this->swarms.size()); k++)
+        {
+            if (running[k] == true)
+            {
+                batch.middleCols(cols, this->swarms[k]->popul.cols()) = this->swarms[k]->popul;
+                cols += this->swarms[k]->popul.cols();
+            }
+        }
+
+        Type_Vec fbatch = this->swarms[first]->obj_function(batch);
+
+        cols = 0;
+
+        for (int k = 0; k < int(this->swarms.size()); k++)
+        {
+            if (running[k] == true)
+            {
+                this->swarms[k]->fpopul = fbatch.segment(cols, this->swarms[k]->popul.cols());
+                this->swarms[k]->accept_evaluation(type);
+
+                cols += this->swarms[k]->popul.cols();
+            }
+        }
+    }
+};
+
+#endif
@@ -5,6 +5,11 @@ Deflection::Deflection(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL
                        std::ostream *output)
 {
     this->swap_point = swap_point;
+    this->dd_swap_point = p.dd_swap_point;
+    this->seed = p.seed;
+    this->stream = p.stream;
+    this->checkpoint = p.checkpoint;
+    this->elite = p.elite;
 
     // Initialize the MPFR model.
 
@@ -15,6 +20,7 @@ Deflection::Deflection(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL
     { // If parameter check fails, return.
         this->initialized = false;
         this->defl_in_double = nullptr;
+        this->defl_in_dd = nullptr;
 
         return;
     }
@@ -28,6 +34,18 @@ Deflection::Deflection(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL
     this->defl_in_double = new Deflection_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY>(
         pso_params_to_double(p), enhanced_params_to_double(ep), "double", double(l), double(constant), precision,
         constriction, LLSH, repulsion, output);
+
+    // Initialize the Double-Double model, if the run continues in double-double
+    // before the MPFR model.
+
+    this->defl_in_dd = nullptr;
+
+    if (p.dd_tier == true)
+    {
+        this->defl_in_dd = new Deflection_Internal<DD_REAL, DD_ARR, DD_VEC, DD_EMPTY>(
+            pso_params_to_dd(p), enhanced_params_to_dd(ep), "dd_real", DD_REAL(l), DD_REAL(constant), precision,
+            constriction, LLSH, repulsion, output);
+    }
 }
 
 Deflection::~Deflection()
@@ -38,6 +56,12 @@ Deflection::~Deflection()
         this->defl_in_double = nullptr;
     }
 
+    if (this->defl_in_dd)
+    {
+        delete this->defl_in_dd;
+        this->defl_in_dd = nullptr;
+    }
+
     if (this->defl_in_mpreal)
     {
         delete this->defl_in_mpreal;
@@ -47,62 +71,144 @@ Deflection::~Deflection()
 
 void Deflection::set_Obj_F(std::string objective_func, const obj_params<MP_REAL> &params)
 {
-    // Set the objective functions for both models.
+    // Set the objective functions for all the models.
 
     this->defl_in_mpreal->set_Obj_F(objective_func, params);
     this->defl_in_double->set_Obj_F(objective_func, obj_params_to_double(params));
+
+    if (this->defl_in_dd != nullptr)
+    {
+        this->defl_in_dd->set_Obj_F(objective_func, obj_params_to_dd(params));
+    }
 }
 
 MPFR_ARR Deflection::fit(int runs)
 {
+    int start = 0;    // The first run (not 0 if the fit is resumed from a checkpoint).
+    bool resume = false;
+    variables v;
+    std::string var_type;
+
     MPFR_ARR mp_result;
     MPFR_EMPTY mp_empty;
 
     DOUBLE_ARR db_result;
-    DOUBLE_EMPTY db_empty;
+
+    DD_ARR dd_result;
 
     mp_result = mp_empty;
 
-    for (int i = 0; i < runs; i++)
+    if (this->seed != 0)
+    {
+        // Reseed the random engine of this thread, so that the run is reproducible.
+        seed_rng(this->seed, this->stream);
+    }
+
+    if (this->checkpoint != "" && checkpoint_load(this->checkpoint, v, var_type, start) == true)
+    {
+        // Resume from the checkpoint, with the minima found in the previous runs.
+
+        resume = true;
+        mp_result = v.result;
+    }
+    else
+    { // A new fit, empty the file of the telemetry records (all the runs append to it).
+        this->defl_in_double->clear_telemetry();
+    }
+
+    for (int i = start; i < runs; i++)
     {
-        // Initialize the results to empty arrays.
-        if (mp_result.size() == 0)
+        std::string stage = "double"; // The model that continues the run.
+        bool imported = false;
+
+        this->defl_in_double->set_run(i);
+        this->defl_in_mpreal->set_run(i);
+
+        if (this->defl_in_dd != nullptr)
         {
-            db_result = db_empty;
+            this->defl_in_dd->set_run(i);
         }
-        else
+
+        if (resume == true)
         {
-            db_result = mpfr_to_double_ARR(mp_result);
-        }
+            // The checkpoint was written in this run, continue it in the model that wrote it
+            // (in mpreal, if it was written by the double-double model and the tier is off).
 
-        // Run the algorithm up until the swap point.
-        db_result = this->defl_in_double->fit(this->swap_point, db_result);
+            resume = false;
+            imported = true;
+            stage = (var_type == "dd_real" && this->defl_in_dd == nullptr) ? "mp_real" : var_type;
+        }
 
-        // If the maximum number (equal to the number of runs) of minima
-        // is found, return them and exit.
-        if (db_result.cols() == runs)
+        if (stage == "double")
         {
-            return double_to_mpfr_ARR(db_result);
+            // The minima found so far, converted into the array of the previous run.
+            cast_into(mp_result, db_result);
+
+            if (imported == true)
+            {
+                this->defl_in_double->var_import(v);
+            }
+
+            // Run the algorithm up until the swap point.
+            db_result = this->defl_in_double->fit(this->swap_point, db_result);
+
+            cast_into(db_result, mp_result);
+
+            // If the maximum number (equal to the number of runs) of minima
+            // is found, return them and exit.
+            if (db_result.cols() == runs)
+            {
+                break;
+            }
+
+            // A stagnated run is not refined, continue with the next run.
+            if (this->defl_in_double->get_status() == "stagnated")
+            {
+                continue;
+            }
+
+            // Export the variables of the double model to the next model.
+            this->defl_in_double->var_export(v);
+            stage = (this->defl_in_dd != nullptr) ? "dd_real" : "mp_real";
         }
 
-        // Import the variables from the double model to the mpreal model.
-        this->defl_in_mpreal->var_import(this->defl_in_double->var_export());
+        if (stage == "dd_real")
+        {
+            this->defl_in_dd->var_import(v);
+
+            // Run in double-double up until the second swap point.
+            dd_result = this->defl_in_dd->fit(this->dd_swap_point, mp_result.template cast<DD_REAL>());
 
-        // Run from the swap point until the algorithm converges or
-        // reaches maximum iterations.
-        mp_result = double_to_mpfr_ARR(db_result);
+            cast_into(dd_result, mp_result);
+
+            if (dd_result.cols() == runs)
+            {
+                break;
+            }
+
+            // The run ended in double-double (a minimum, maximum iterations or stagnation).
+            if (this->defl_in_dd->get_status() != "swap")
+            {
+                continue;
+            }
+
+            this->defl_in_dd->var_export(v);
+        }
+
+        // Import the variables to the mpreal model and run from the swap point
+        // until the algorithm converges or reaches maximum iterations.
+        select_elite(v, this->elite);
+        this->defl_in_mpreal->var_import(std::move(v));
 
         mp_result = this->defl_in_mpreal->fit(this->swap_point, mp_result);
     }
 
-    if (db_result.cols() == runs)
+    if (this->checkpoint != "")
     {
-        return double_to_mpfr_ARR(db_result);
-    }
-    else
-    {
-        return mp_result;
+        std::remove(this->checkpoint.c_str()); // All the runs are complete.
     }
+
+    return mp_result;
 }
 
 Deflection *Deflection_Init(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL> &ep, double swap_point,
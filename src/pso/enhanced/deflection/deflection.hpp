@@ -15,6 +15,11 @@ class Deflection
     bool parameter_check();
 
     void print_params();
+
+    int get_swap_iteration();
+    double get_swap_value();
+    int get_dd_swap_iteration();
+    double get_dd_swap_value();
     void set_Obj_F(std::string objective_func, const obj_params<MP_REAL> &params);
 
     MPFR_ARR fit(int runs = 1);
@@ -22,9 +27,15 @@ class Deflection
   private:
     bool initialized;
     double swap_point;
+    double dd_swap_point;
+    uint64_t seed;
+    uint64_t stream;
+    std::string checkpoint;
+    int elite; // The particles that continue in mpreal (0: the whole swarm).
 
     Deflection_Internal<MP_REAL, MPFR_ARR, MPFR_VEC, MPFR_EMPTY> *defl_in_mpreal;
     Deflection_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY> *defl_in_double;
+    Deflection_Internal<DD_REAL, DD_ARR, DD_VEC, DD_EMPTY> *defl_in_dd; // nullptr if the double-double tier is off.
 };
 
 inline bool Deflection::is_initialized()
@@ -42,6 +53,34 @@ inline void Deflection::print_params()
     this->defl_in_mpreal->print_params();
 }
 
+inline int Deflection::get_swap_iteration()
+{
+    return this->defl_in_double->get_swap_iteration();
+}
+
+inline double Deflection::get_swap_value()
+{
+    return this->defl_in_double->get_swap_value();
+}
+
+inline int Deflection::get_dd_swap_iteration()
+{
+    // The iteration of the swap from dd_real to mpreal, -1 if there was none
+    // (the dd_real tier is off, or the last run did not reach it).
+
+    if (this->defl_in_dd == nullptr || this->defl_in_double->get_swap_iteration() == -1)
+    {
+        return -1;
+    }
+
+    return this->defl_in_dd->get_swap_iteration();
+}
+
+inline double Deflection::get_dd_swap_value()
+{
+    return (this->get_dd_swap_iteration() == -1) ? 0 : this->defl_in_dd->get_swap_value();
+}
+
 Deflection *Deflection_Init(pso_params<MP_REAL, MPFR_ARR> &p, enhanced_params<MP_REAL> &ep, double swap_point,
                             MP_REAL l, MP_REAL constant, int precision = 64, bool constriction = false,
                             bool LLSH = false, bool repulsion = false, std::ostream *output = &(std::cout));
@@ -49,7 +49,7 @@ class Deflection_Internal : public Enhanced<Type, Type_Arr, Type_Vec, Type_Empty
         (*this->output) << "\\-------------------------" << std::endl;
     }
 
-    Type_Arr fit(double swap_point, Type_Arr result)
+    Type_Arr fit(double swap_point, const Type_Arr &result)
     {
         bool success = false;
 
@@ -115,24 +115,52 @@ class Deflection_Internal : public Enhanced<Type, Type_Arr, Type_Vec, Type_Empty
     Type l;
     Type constant; // The value of the minimum that the algorithm converges to.
 
-    Type_Vec Pi(Type_Arr popul)
+    Type_Vec Pi(const Type_Arr &popul)
     {
         // Please refer to the publication for this function.
 
-        Type_Vec Ones_vec = Type_Vec::Ones(this->p.popsize);
-        Type_Vec Pi_result = Type_Vec::Ones(this->p.popsize);
+        int n = popul.cols(); // The population, or a single particle (asynchronous PSO).
+
+        Type_Vec Ones_vec = Type_Vec::Ones(n);
+        Type_Vec Pi_result = Type_Vec::Ones(n);
 
         if (this->result.size() == 0)
         {
             return Pi_result;
         }
+        else if constexpr (std::is_same_v<Type, MP_REAL>)
+        {
+            // In place, with the temporaries in an arena of the calling thread
+            // (the asynchronous PSO evaluates the particles in its workers).
+
+            thread_local mp_arena scratch;
+
+            scratch.resize(2, 1, this->precision);
+
+            mpfr_ptr t = scratch(0);
+
+            for (int i = 0; i < this->result.cols(); i++)
+            {
+                for (int j = 0; j < n; j++)
+                {
+                    // Pi = Pi * (1 / T), with T = tanh(l * ||x - x_star||).
+                    lmath::distance(t, popul.col(j).data(), this->result.col(i).data(), this->p.dim, scratch(1));
+                    mpfr_mul(t, this->l.mpfr_srcptr(), t, MPFR_RNDN);
+                    mpfr_tanh(t, t, MPFR_RNDN);
+                    mpfr_ui_div(t, 1, t, MPFR_RNDN);
+                    mpfr_mul(Pi_result(j).mpfr_ptr(), Pi_result(j).mpfr_srcptr(), t, MPFR_RNDN);
+                }
+            }
+
+            return Pi_result;
+        }
         else
         {
             for (int i = 0; i < this->result.cols(); i++)
             {
-                Type_Arr curr_minimum(this->p.dim, this->p.popsize);
+                Type_Arr curr_minimum(this->p.dim, n);
 
-                curr_minimum = this->result.col(i).replicate(1, this->p.popsize);
+                curr_minimum = this->result.col(i).replicate(1, n);
                 Pi_result = Pi_result.array() * (Ones_vec.array() / this->T(popul, curr_minimum).array()).array();
             }
 
@@ -140,14 +168,14 @@ class Deflection_Internal : public Enhanced<Type, Type_Arr, Type_Vec, Type_Empty
         }
     }
 
-    Type_Vec T(Type_Arr x, Type_Arr x_star)
+    Type_Vec T(const Type_Arr &x, const Type_Arr &x_star)
     {
         // Please refer to the publication for this function.
 
         return ((this->l * (x - x_star).colwise().norm()).array()).tanh();
     }
 
-    Type_Vec obj_function(Type_Arr particles) override
+    Type_Vec obj_function(const Type_Arr &particles) override
     {
         return ((this->Obj_F->call(particles).array() + this->constant) * this->Pi(particles).array());
     }
@@ -2,6 +2,9 @@
 #define __ENH__
 
 #include "../../lsh/lsh.hpp"
+#include "../../neighbourhood/cell_list/cell_list.hpp"
+#include "../../neighbourhood/kd_tree/kd_tree.hpp"
+#include "../../neighbourhood/topology/topology.hpp"
 #include "../pso.hpp"
 
 template <typename Type> struct enhanced_params
@@ -14,19 +17,30 @@ template <typename Type> struct enhanced_params
     int lsh_k = 5;
     int lsh_w = 3;
     int lsh_L = 30;
+    int lsh_refresh = 1;
+    int lsh_probes = 0;
+    int topology_k = 3;
+    int topology_refresh = 10;
     Type con_k = 1;
     Type rep_rho = 0.2;
     Type rep_radius = 0.1;
     Type lsh_radius = 0.2;
+    std::string neighbourhood = "lsh"; // The neighbourhood index: "lsh", "cell_list" or "kd_tree",
+                                       // or a static topology: "ring", "von_neumann" or "random".
 };
 
-template <typename Type> enhanced_params<MP_REAL> enhanced_params_to_mpfr(enhanced_params<Type> params)
+template <typename Type> enhanced_params<MP_REAL> enhanced_params_to_mpfr(const enhanced_params<Type> &params)
 {
     enhanced_params<MP_REAL> mpfr_params;
 
     mpfr_params.lsh_k = params.lsh_k;
     mpfr_params.lsh_w = params.lsh_w;
     mpfr_params.lsh_L = params.lsh_L;
+    mpfr_params.lsh_refresh = params.lsh_refresh;
+    mpfr_params.lsh_probes = params.lsh_probes;
+    mpfr_params.topology_k = params.topology_k;
+    mpfr_params.topology_refresh = params.topology_refresh;
+    mpfr_params.neighbourhood = params.neighbourhood;
     mpfr_params.con_k = MP_REAL(params.con_k);
     mpfr_params.rep_rho = MP_REAL(params.rep_rho);
     mpfr_params.rep_radius = MP_REAL(params.rep_radius);
@@ -35,13 +49,18 @@ template <typename Type> enhanced_params<MP_REAL> enhanced_params_to_mpfr(enhanc
     return mpfr_params;
 }
 
-template <typename Type> enhanced_params<double> enhanced_params_to_double(enhanced_params<Type> params)
+template <typename Type> enhanced_params<double> enhanced_params_to_double(const enhanced_params<Type> &params)
 {
     enhanced_params<double> double_params;
 
     double_params.lsh_k = params.lsh_k;
     double_params.lsh_w = params.lsh_w;
     double_params.lsh_L = params.lsh_L;
+    double_params.lsh_refresh = params.lsh_refresh;
+    double_params.lsh_probes = params.lsh_probes;
+    double_params.topology_k = params.topology_k;
+    double_params.topology_refresh = params.topology_refresh;
+    double_params.neighbourhood = params.neighbourhood;
     double_params.con_k = double(params.con_k);
     double_params.rep_rho = double(params.rep_rho);
     double_params.rep_radius = double(params.rep_radius);
@@ -50,6 +69,26 @@ template <typename Type> enhanced_params<double> enhanced_params_to_double(enhan
     return double_params;
 }
 
+template <typename Type> enhanced_params<DD_REAL> enhanced_params_to_dd(const enhanced_params<Type> &params)
+{
+    enhanced_params<DD_REAL> dd_params;
+
+    dd_params.lsh_k = params.lsh_k;
+    dd_params.lsh_w = params.lsh_w;
+    dd_params.lsh_L = params.lsh_L;
+    dd_params.lsh_refresh = params.lsh_refresh;
+    dd_params.lsh_probes = params.lsh_probes;
+    dd_params.topology_k = params.topology_k;
+    dd_params.topology_refresh = params.topology_refresh;
+    dd_params.neighbourhood = params.neighbourhood;
+    dd_params.con_k = DD_REAL(params.con_k);
+    dd_params.rep_rho = DD_REAL(params.rep_rho);
+    dd_params.rep_radius = DD_REAL(params.rep_radius);
+    dd_params.lsh_radius = DD_REAL(params.lsh_radius);
+
+    return dd_params;
+}
+
 template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Empty>
 class Enhanced : public PSO<Type, Type_Arr, Type_Vec, Type_Empty>
 {
@@ -66,8 +105,22 @@ class Enhanced : public PSO<Type, Type_Arr, Type_Vec, Type_Empty>
         {
             this->constriction_init();
         }
+
+        this->nbh = nullptr;
+        this->topo = nullptr;
+        this->nbh_age = 0;
+        this->queries_popsize = 0;
     };
 
+    ~Enhanced()
+    {
+        delete this->nbh;
+        this->nbh = nullptr;
+
+        delete this->topo;
+        this->topo = nullptr;
+    }
+
     bool parameter_check() override
     {
         // A function that checks if the parameters provided are
@@ -95,38 +148,95 @@ class Enhanced : public PSO<Type, Type_Arr, Type_Vec, Type_Empty>
 
         if (this->lsh_flag == true)
         {
-            if (this->ep.lsh_k < 4)
+            if (this->ep.neighbourhood != "lsh" && this->ep.neighbourhood != "cell_list" &&
+                this->ep.neighbourhood != "kd_tree" && this->is_topology() == false)
             {
-                std::cout << "~> Error: In order for LSH to work reliably, the number of  " << std::endl;
-                std::cout << "function h() in each hash function g() should be at least 4." << std::endl;
+                std::cout << "~> Error: Please select a correct neighbourhood. [lsh], [cell_list], [kd_tree],"
+                          << std::endl;
+                std::cout << "[ring], [von_neumann] or [random]." << std::endl;
 
                 return false;
             }
-            else if (this->ep.lsh_w < 2)
-            {
-                std::cout << "~> Error: W coefficient in LSH should be greater or equal to 2." << std::endl;
+            else if (this->is_topology() == true)
+            { // A static topology does not use the parameters of the indices.
+                if (this->ep.topology_k < 1)
+                {
+                    std::cout << "~> Error: The random topology should have at least 1 informant (k) per particle."
+                              << std::endl;
 
-                return false;
+                    return false;
+                }
+                else if (this->ep.topology_refresh < 0)
+                {
+                    std::cout << "~> Error: The topology refresh period should be greater or equal to 0."
+                              << std::endl;
+
+                    return false;
+                }
             }
-            else if (this->ep.lsh_L < 5)
+            else if (this->ep.lsh_radius <= 0 || this->ep.lsh_radius > 1)
             {
-                std::cout << "~> Error: For LSH to work reliably there should exist at least 5 hash tables (L)."
+                std::cout << "~> Error: The LSH effective radius should be greater than 0 and smaller or equal to 1."
                           << std::endl;
 
                 return false;
             }
-            else if (this->ep.lsh_radius <= 0 || this->ep.lsh_radius > 1)
-            {
-                std::cout << "~> Error: The LSH effective radius should be greater than 0 and smaller or equal to 1."
+            else if (this->p.elite > 0 && this->p.elite < 8)
+            { // The index finds the best of popsize / 4 neighbours, the refining swarm needs at least 2.
+                std::cout << "~> Error: With a neighbourhood index, at least 8 elite particles should continue"
                           << std::endl;
+                std::cout << "in mpreal (0: the whole swarm)." << std::endl;
 
                 return false;
             }
+            else if (this->ep.neighbourhood == "lsh")
+            {
+                if (this->ep.lsh_k < 4)
+                {
+                    std::cout << "~> Error: In order for LSH to work reliably, the number of  " << std::endl;
+                    std::cout << "function h() in each hash function g() should be at least 4." << std::endl;
+
+                    return false;
+                }
+                else if (this->ep.lsh_w < 2)
+                {
+                    std::cout << "~> Error: W coefficient in LSH should be greater or equal to 2." << std::endl;
+
+                    return false;
+                }
+                else if (this->ep.lsh_probes < 0 || this->ep.lsh_probes > 2 * this->ep.lsh_k)
+                {
+                    std::cout << "~> Error: The LSH probes should be between 0 and 2k (the adjacent buckets)."
+                              << std::endl;
+
+                    return false;
+                }
+                else if (this->ep.lsh_L < 1 || this->ep.lsh_L * (1 + this->ep.lsh_probes) < 5)
+                {
+                    std::cout << "~> Error: For LSH to work reliably there should exist at least 5 hash tables (L),"
+                              << std::endl;
+                    std::cout << "or at least 5 buckets visited in them (L * (1 + probes))." << std::endl;
+
+                    return false;
+                }
+                else if (this->ep.lsh_refresh < 0)
+                {
+                    std::cout << "~> Error: The LSH refresh period should be greater or equal to 0." << std::endl;
+
+                    return false;
+                }
+            }
         }
 
         if (this->rep_flag == true)
         {
-            if (this->ep.rep_rho == 0)
+            if (this->p.async_threads > 0)
+            {
+                std::cout << "~> Error: Repulsion cannot be used with the asynchronous PSO." << std::endl;
+
+                return false;
+            }
+            else if (this->ep.rep_rho == 0)
             {
                 std::cout << "~> Error: Rho should not be equal to 0." << std::endl;
 
@@ -152,7 +262,12 @@ class Enhanced : public PSO<Type, Type_Arr, Type_Vec, Type_Empty>
         (*this->output) << "/-- Enhanced Parameters --" << std::endl;
         (*this->output) << "|- lsh k            : " << this->ep.lsh_k << std::endl;
         (*this->output) << "|- lsh L            : " << this->ep.lsh_L << std::endl;
+        (*this->output) << "|- lsh refresh      : " << this->ep.lsh_refresh << std::endl;
+        (*this->output) << "|- lsh probes       : " << this->ep.lsh_probes << std::endl;
         (*this->output) << "|- lsh radius       : " << this->ep.lsh_radius << std::endl;
+        (*this->output) << "|- neighbourhood    : " << this->ep.neighbourhood << std::endl;
+        (*this->output) << "|- topology k       : " << this->ep.topology_k << std::endl;
+        (*this->output) << "|- topology refresh : " << this->ep.topology_refresh << std::endl;
         (*this->output) << "|- constriction k   : " << this->ep.con_k << std::endl;
         (*this->output) << "|- repulsion rho    : " << this->ep.rep_rho << std::endl;
         (*this->output) << "|- repulsion radius : " << this->ep.rep_radius << std::endl;
@@ -164,6 +279,15 @@ class Enhanced : public PSO<Type, Type_Arr, Type_Vec, Type_Empty>
     bool lsh_flag;  // LSH flag.
     bool rep_flag;  // Repulsion flag.
     Type con_coeff; // Constriction coefficient.
+    Type_Arr N;     // Workspace for the neighbourhood attractors (LSH).
+    int nbh_age;    // The iterations since the hash functions (or the random topology) were drawn.
+
+    neighbourhood<double, DOUBLE_ARR, DOUBLE_VEC> *nbh;     // The neighbourhood index, kept between iterations.
+    DOUBLE_ARR nbh_popul;                                   // The double copy of popul the index is built on.
+    std::vector<priority_list<double, DOUBLE_VEC>> queries; // The scratch lists of the queries (one per thread).
+    int queries_popsize;                                    // The popsize the scratch lists were made for.
+    topology *topo;                                         // The static topology, kept between iterations.
+    Eigen::Vector<int, Eigen::Dynamic> nbest;               // The best informant of every particle (topologies).
 
     enhanced_params<Type> ep;
 
@@ -197,7 +321,15 @@ class Enhanced : public PSO<Type, Type_Arr, Type_Vec, Type_Empty>
         // The repulsion function that can be used alongside deflection.
         // Please refer to the publication for more information.
 
-        if (this->result.size() > 0)
+        if (this->result.size() == 0)
+        {
+            return;
+        }
+        else if constexpr (std::is_same_v<Type, MP_REAL>)
+        {
+            this->repulsion_mpfr();
+        }
+        else
         {
             for (int i = 0; i < int(this->result.cols()); i++)
             {
@@ -233,123 +365,283 @@ class Enhanced : public PSO<Type, Type_Arr, Type_Vec, Type_Empty>
         }
     }
 
-    void constriction()
+    void repulsion_mpfr()
+    {
+        // The repulsion with the in-place MPFR functions and the temporaries
+        // in the scratch arena (the same operations as repulsion()).
+
+        mpfr_ptr d = this->scratch(0);
+        mpfr_ptr t = this->scratch(1);
+
+        for (int i = 0; i < int(this->result.cols()); i++)
+        {
+            for (int j = 0; j < int(this->p.popsize); j++)
+            {
+                lmath::distance(d, this->result.col(i).data(), this->popul.col(j).data(), this->p.dim, t);
+
+                if (mpfr_lessequal_p(d, this->ep.rep_radius.mpfr_srcptr()))
+                { // Move the particle by rho along the unitary vector z = (x - minimum) / d.
+                    for (int k = 0; k < this->p.dim; k++)
+                    {
+                        mpfr_ptr x = this->popul(k, j).mpfr_ptr();
+
+                        mpfr_sub(t, x, this->result(k, i).mpfr_srcptr(), MPFR_RNDN);
+                        mpfr_div(t, t, d, MPFR_RNDN);
+                        mpfr_mul(t, this->ep.rep_rho.mpfr_srcptr(), t, MPFR_RNDN);
+                        mpfr_add(x, x, t, MPFR_RNDN);
+                    }
+
+                    if (this->bestpos.size() > 0)
+                    {
+                        this->bestpos.col(j) = this->popul.col(j);
+                    }
+                    if (this->fbestpos.size() > 0)
+                    {
+                        this->fbestpos(j) = lmath::get_infinity<Type>();
+                    }
+                }
+            }
+        }
+    }
+
+    void allocate_workspace() override
     {
-        // Apply velocity constriction.
+        PSO<Type, Type_Arr, Type_Vec, Type_Empty>::allocate_workspace();
 
-        this->vel = this->con_coeff * this->vel.array();
+        this->N = Type_Arr(this->p.dim, this->p.popsize);
     }
 
     void swarm_update() override
     {
-        this->popul = this->popul + this->vel;
+        // The positions are already advanced by the fused kernel.
         this->repulsion(); // Repulsion is applied after the particle update.
     }
 
-    void velocity_update(Type w) override
+    const Type *social_attractor(int i) override
     {
-        int dim = this->p.dim;
-        int popsize = this->p.popsize;
-
-        Type_Arr A(dim, popsize);
-        Type_Arr N(dim, popsize);
-        Type_Arr R1(dim, popsize);
-        Type_Arr R2(dim, popsize);
+        // With LSH, the social attractor is the best neighbour of the particle.
+        // If LSH is not set to true, proceed with the classic PSO algorithm
+        // (the social attractor is the global best particle).
 
         if (this->lsh_flag == true)
         {
-            // If the LSH flag is true, use LSH to calculate the new particle velocity.
+            if (this->nbest.size() > 0 && this->is_topology() == true)
+            { // (a static topology, the best position of the best informant)
+                return this->bestpos.col(this->nbest(i)).data();
+            }
+
+            return this->N.col(i).data();
+        }
+
+        return PSO<Type, Type_Arr, Type_Vec, Type_Empty>::social_attractor(i);
+    }
 
-            LSH<Type, Type_Arr, Type_Vec> *lsh =
-                new LSH<Type, Type_Arr, Type_Vec>(this->ep.lsh_k, this->ep.lsh_w, this->ep.lsh_L, this->p.err_goal,
-                                                  this->ep.lsh_radius, this->p.bounds, this->popul);
+    const Type *constriction_coeff() override
+    {
+        return (this->con_flag == true) ? &(this->con_coeff) : nullptr;
+    }
 
-            for (int i = 0; i < popsize; i++)
+    void neighbourhood_update() override
+    {
+        // Find the best neighbour of every particle (the N array).
+
+        int popsize = this->p.popsize;
+
+        if (this->lsh_flag == true && this->is_topology() == true)
+        {
+            this->topology_update();
+        }
+        else if (this->lsh_flag == true)
+        {
+            // If the LSH flag is true, use the neighbourhood index (LSH by
+            // default) to find the neighbours.
+
+            // The LSH hash functions are drawn again every lsh_refresh
+            // iterations (never if it is 0). In between, only the particles
+            // that moved are rehashed. The exact indices are only updated.
+
+            const DOUBLE_ARR &positions = this->nbh_population();
+
+            if (this->nbh == nullptr || this->nbh->get_size() != popsize ||
+                (this->ep.neighbourhood == "lsh" && this->ep.lsh_refresh > 0 && this->nbh_age >= this->ep.lsh_refresh))
+            {
+                delete this->nbh;
+
+                this->nbh = this->new_neighbourhood(positions);
+                this->nbh_age = 0;
+            }
+            else
             {
-                // Initialize the best distance of a particle to infinity,
-                Type best_dist = lmath::get_infinity<Type>();
+                this->nbh->update(positions);
+            }
 
-                // find its closest neighbours (their indeces) and
-                Eigen::Vector<int, Eigen::Dynamic> particle_neighbours = lsh->find_idx(this->popul.col(i));
+            this->nbh_age++;
 
-                // save the closest particle (that is not the particle itself)
-                // in the N array.
-                for (int j = 0; j < particle_neighbours.size(); j++)
-                {
-                    if (i == particle_neighbours(j) && particle_neighbours.size() != 1)
-                    {
-                        continue;
-                    }
+            // The queries only read the index, so the particles are split
+            // in blocks between the threads of the objective function. Every
+            // block has its own scratch list, kept between the iterations.
+            int threads = (this->Obj_F != nullptr) ? std::max(1, this->Obj_F->get_threads()) : 1;
 
-                    if (this->fpopul(particle_neighbours(j)) < best_dist)
-                    {
-                        N.col(i) = this->popul.col(particle_neighbours(j));
-                        best_dist = this->fpopul(particle_neighbours(j));
-                    }
+            if (int(this->queries.size()) != threads || this->queries_popsize != popsize)
+            {
+                this->queries.assign(threads, priority_list<double, DOUBLE_VEC>(this->nbh->get_neighbours(), popsize));
+                this->queries_popsize = popsize;
+            }
+
+#pragma omp parallel for num_threads(threads) if (threads > 1)
+            for (int t = 0; t < threads; t++)
+            {
+                mpfr::mpreal::set_default_prec(this->precision);
+
+                for (int i = t * popsize / threads; i < (t + 1) * popsize / threads; i++)
+                {
+                    this->best_neighbour(i, positions, this->queries[t]);
                 }
             }
+        }
+    }
+
+    inline bool is_topology() const
+    {
+        return this->ep.neighbourhood == "ring" || this->ep.neighbourhood == "von_neumann" ||
+               this->ep.neighbourhood == "random";
+    }
+
+    void topology_update()
+    {
+        // Find the best informant of every particle in the static topology.
+        // The informants do not depend on the positions, so there is no
+        // index to update: the topology is only built again if the popsize
+        // changed, and the random one every topology_refresh iterations
+        // (never if it is 0).
+
+        if (this->topo == nullptr || this->topo->get_size() != this->p.popsize ||
+            (this->ep.neighbourhood == "random" && this->ep.topology_refresh > 0 &&
+             this->nbh_age >= this->ep.topology_refresh))
+        {
+            delete this->topo;
 
-            delete lsh;
-            lsh = nullptr;
+            this->topo = new topology(this->ep.neighbourhood, this->p.popsize, this->ep.topology_k);
+            this->nbh_age = 0;
+        }
+
+        this->nbh_age++;
+
+        if (this->fbestpos.size() != this->p.popsize)
+        { // (no best positions yet, every particle is its own attractor)
+            this->nbest.resize(0);
+            this->N = this->popul;
+
+            return;
+        }
+
+        this->topo->best_informants(this->fbestpos, this->nbest);
+    }
+
+    const DOUBLE_ARR &nbh_population()
+    {
+        // The positions the neighbourhood index is built and queried on.
+        // The index only finds which particles are close, which does not
+        // need the precision of Type, so it always works in double: on
+        // popul itself in double, or on a copy of it (nbh_popul) otherwise.
+
+        if constexpr (std::is_same_v<Type, double>)
+        {
+            return this->popul;
         }
         else
         {
-            // If LSH is not set to true, proceed with the classic PSO algorithm.
-            A = this->bestpos.col(this->g).replicate(1, this->bestpos.cols());
+            cast_into(this->popul, this->nbh_popul);
 
-            for (int i = 0; i < this->bestpos.cols(); i++)
-            {
-                A.col(i) = this->bestpos.col(this->g);
-            }
+            return this->nbh_popul;
         }
+    }
+
+    neighbourhood<double, DOUBLE_ARR, DOUBLE_VEC> *new_neighbourhood(const DOUBLE_ARR &positions)
+    {
+        // Build the neighbourhood index that ep.neighbourhood selects on the population.
 
-        R1 = Type_Arr::NullaryExpr(dim, popsize, [&]() { return Type(uniform_real(0, 1)); });
-        R2 = Type_Arr::NullaryExpr(dim, popsize, [&]() { return Type(uniform_real(0, 1)); });
+        double radius = double(this->ep.lsh_radius);
+        DOUBLE_ARR bounds;
 
-        if (this->lsh_flag == true)
+        cast_into(this->p.bounds, bounds);
+
+        if (this->ep.neighbourhood == "cell_list")
         {
-            this->vel =
-                w * this->vel + this->p.c1 * R1 * (this->bestpos - this->popul) + this->p.c2 * R2 * (N - this->popul);
+            return new cell_list<double, DOUBLE_ARR, DOUBLE_VEC>(radius, bounds, positions);
         }
-        else
+        else if (this->ep.neighbourhood == "kd_tree")
         {
-            this->vel =
-                w * this->vel + this->p.c1 * R1 * (this->bestpos - this->popul) + this->p.c2 * R2 * (A - this->popul);
+            return new kd_tree<double, DOUBLE_ARR, DOUBLE_VEC>(radius, bounds, positions);
         }
 
-        this->vel_clamp();
+        return new LSH<double, DOUBLE_ARR, DOUBLE_VEC>(this->ep.lsh_k, this->ep.lsh_w, this->ep.lsh_L,
+                                                       this->ep.lsh_probes, radius, bounds, positions);
+    }
+
+    void best_neighbour(int i, const DOUBLE_ARR &positions, priority_list<double, DOUBLE_VEC> &neighbours)
+    {
+        // Save the best neighbour of a particle in the N array.
 
-        if (this->con_flag == true)
+        // Initialize the best distance of a particle to infinity,
+        Type best_dist = lmath::get_infinity<Type>();
+
+        // (if no neighbour has a finite fitness, the particle is its own attractor),
+        this->N.col(i) = this->popul.col(i);
+
+        // find its closest neighbours (their indeces, in double) and
+        Eigen::Vector<int, Eigen::Dynamic> particle_neighbours = this->nbh->find_idx(positions.col(i), neighbours);
+
+        // save the best of them (that is not the particle itself, compared
+        // in Type) in the N array.
+        for (int j = 0; j < particle_neighbours.size(); j++)
         {
-            this->constriction();
+            if (i == particle_neighbours(j) && particle_neighbours.size() != 1)
+            {
+                continue;
+            }
+
+            if (this->fpopul(particle_neighbours(j)) < best_dist)
+            {
+                this->N.col(i) = this->popul.col(particle_neighbours(j));
+                best_dist = this->fpopul(particle_neighbours(j));
+            }
         }
     }
 
-    void evaluate_swarm(std::string type = "") override
+    void velocity_update(Type w) override
     {
-        // Evaluate position.
+        this->neighbourhood_update();
 
-        // Initialize best position matrices.
+        uniform_real_fill(this->R1, 0, 1);
+        uniform_real_fill(this->R2, 0, 1);
+
+        // Velocity update, clamp, constriction and position update
+        // run as one fused pass.
+        this->dispatch_dim([&](auto D) { this->template swarm_kernel<decltype(D)::value>(w); });
+    }
+
+    void prepare_evaluation(std::string type) override
+    {
         if (type == "initial")
         {
             this->repulsion();
-            this->fpopul = this->obj_function(this->popul);
+        }
+    }
 
+    void accept_evaluation(std::string type) override
+    {
+        this->evaluations += this->popul.cols();
+
+        // Initialize best position matrices.
+        if (type == "initial")
+        {
             this->bestpos = this->popul;
             this->fbestpos = this->fpopul;
         }
         else
         {
-            this->fpopul = this->obj_function(this->popul);
-
-            for (int i = 0; i < this->fpopul.rows(); i++)
-            {
-                if (this->fpopul(i) < this->fbestpos(i))
-                {
-                    this->fbestpos(i) = this->fpopul(i);
-                    this->bestpos.col(i) = this->popul.col(i);
-                }
-            }
+            this->dispatch_dim([&](auto D) { this->template update_best<decltype(D)::value>(); });
         }
 
         // Find best particle in the population.
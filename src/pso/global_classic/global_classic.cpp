@@ -3,6 +3,11 @@
 Global_Classic::Global_Classic(pso_params<MP_REAL, MPFR_ARR> &p, double swap_point, int precision, std::ostream *output)
 {
     this->swap_point = swap_point;
+    this->dd_swap_point = p.dd_swap_point;
+    this->seed = p.seed;
+    this->stream = p.stream;
+    this->checkpoint = p.checkpoint;
+    this->elite = p.elite;
 
     // Initialize the MPFR model.
 
@@ -13,6 +18,7 @@ Global_Classic::Global_Classic(pso_params<MP_REAL, MPFR_ARR> &p, double swap_poi
     { // If parameter check fails, return.
         this->initialized = false;
         this->gclc_in_double = nullptr;
+        this->gclc_in_dd = nullptr;
 
         return;
     }
@@ -25,6 +31,17 @@ Global_Classic::Global_Classic(pso_params<MP_REAL, MPFR_ARR> &p, double swap_poi
 
     this->gclc_in_double = new Global_Classic_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY>(
         pso_params_to_double(p), "double", precision, output);
+
+    // Initialize the Double-Double model, if the run continues in double-double
+    // before the MPFR model.
+
+    this->gclc_in_dd = nullptr;
+
+    if (p.dd_tier == true)
+    {
+        this->gclc_in_dd = new Global_Classic_Internal<DD_REAL, DD_ARR, DD_VEC, DD_EMPTY>(pso_params_to_dd(p), "dd_real",
+                                                                                          precision, output);
+    }
 }
 
 Global_Classic::~Global_Classic()
@@ -35,6 +52,12 @@ Global_Classic::~Global_Classic()
         this->gclc_in_double = nullptr;
     }
 
+    if (this->gclc_in_dd)
+    {
+        delete this->gclc_in_dd;
+        this->gclc_in_dd = nullptr;
+    }
+
     if (this->gclc_in_mpreal)
     {
         delete this->gclc_in_mpreal;
@@ -44,32 +67,114 @@ Global_Classic::~Global_Classic()
 
 void Global_Classic::set_Obj_F(std::string objective_func, const obj_params<MP_REAL> &params)
 {
-    // Set the objective functions for both models.
+    // Set the objective functions for all the models.
 
     this->gclc_in_mpreal->set_Obj_F(objective_func, params);
     this->gclc_in_double->set_Obj_F(objective_func, obj_params_to_double(params));
+
+    if (this->gclc_in_dd != nullptr)
+    {
+        this->gclc_in_dd->set_Obj_F(objective_func, obj_params_to_dd(params));
+    }
 }
 
 MPFR_ARR Global_Classic::fit()
 {
+    int run;
+    variables v;
+    std::string var_type = "double"; // The model that continues the run.
+    bool resume = false;
+
+    MPFR_ARR result;
     DOUBLE_ARR double_result;
+    DD_ARR dd_result;
 
-    // Run the algorithm up until the swap point.
-    double_result = this->gclc_in_double->fit(this->swap_point);
+    if (this->seed != 0)
+    {
+        // Reseed the random engine of this thread, so that the run is reproducible.
+        seed_rng(this->seed, this->stream);
+    }
 
-    if (double_result.size() > 0)
+    if (this->checkpoint != "" && checkpoint_load(this->checkpoint, v, var_type, run) == true)
     {
-        // If a minimum is found, return it and exit.
+        // Resume the run from the checkpoint, in the model that wrote it.
+
+        resume = true;
 
-        return double_to_mpfr_ARR(double_result);
+        if (var_type == "dd_real" && this->gclc_in_dd == nullptr)
+        { // The double-double model is disabled, continue in mpreal.
+            var_type = "mp_real";
+        }
     }
+    else
+    { // A new run, empty the file of the telemetry records.
+        this->gclc_in_double->clear_telemetry();
+    }
+
+    if (var_type == "double")
+    {
+        if (resume == true)
+        {
+            this->gclc_in_double->var_import(v);
+        }
+
+        // Run the algorithm up until the swap point.
+        double_result = this->gclc_in_double->fit(this->swap_point);
+
+        if (double_result.size() > 0 || this->gclc_in_double->get_status() == "stagnated")
+        {
+            // If a minimum is found (or the swarm stagnated and the run was aborted),
+            // there is nothing to refine.
+
+            result = double_to_mpfr_ARR(double_result);
+            var_type = "";
+        }
+        else
+        {
+            // Export the variables of the double model to the next model.
+
+            this->gclc_in_double->var_export(v);
+            var_type = (this->gclc_in_dd != nullptr) ? "dd_real" : "mp_real";
+        }
+    }
+
+    if (var_type == "dd_real")
+    {
+        this->gclc_in_dd->var_import(v);
+
+        // Run in double-double up until the second swap point.
+        dd_result = this->gclc_in_dd->fit(this->dd_swap_point);
+
+        if (this->gclc_in_dd->get_status() != "swap")
+        {
+            // The run ended in double-double (a minimum, maximum iterations or stagnation).
+
+            result = dd_result.template cast<MP_REAL>();
+            var_type = "";
+        }
+        else
+        {
+            this->gclc_in_dd->var_export(v);
+            var_type = "mp_real";
+        }
+    }
+
+    if (var_type == "mp_real")
+    {
+        select_elite(v, this->elite);
+        this->gclc_in_mpreal->var_import(std::move(v));
 
-    // Import the variables from the double model to the mpreal model.
-    this->gclc_in_mpreal->var_import(this->gclc_in_double->var_export());
+        // Run from the swap point until the algorithm converges or
+        // reaches maximum iterations, return the minimum (if one is found).
+        result = this->gclc_in_mpreal->fit(this->swap_point);
+    }
+
+    if (this->checkpoint != "")
+    {
+        std::remove(this->checkpoint.c_str()); // The run is complete.
+    }
 
-    // Run from the swap point until the algorithm converges or
-    // reaches maximum iterations, return the minimum (if one is found) and exit.
-    return this->gclc_in_mpreal->fit(this->swap_point);
+    return result;
 }
 
 Global_Classic *Global_Classic_Init(pso_params<MP_REAL, MPFR_ARR> &p, double swap_point, int precision,
@@ -14,6 +14,11 @@ class Global_Classic
     bool parameter_check();
 
     void print_params();
+
+    int get_swap_iteration();
+    double get_swap_value();
+    int get_dd_swap_iteration();
+    double get_dd_swap_value();
     void set_Obj_F(std::string objective_func, const obj_params<MP_REAL> &params);
 
     MPFR_ARR fit();
@@ -21,9 +26,15 @@ class Global_Classic
   private:
     bool initialized;
     double swap_point;
+    double dd_swap_point;
+    uint64_t seed;
+    uint64_t stream;
+    std::string checkpoint;
+    int elite; // The particles that continue in mpreal (0: the whole swarm).
 
     Global_Classic_Internal<MP_REAL, MPFR_ARR, MPFR_VEC, MPFR_EMPTY> *gclc_in_mpreal;
     Global_Classic_Internal<double, DOUBLE_ARR, DOUBLE_VEC, DOUBLE_EMPTY> *gclc_in_double;
+    Global_Classic_Internal<DD_REAL, DD_ARR, DD_VEC, DD_EMPTY> *gclc_in_dd; // nullptr if the double-double tier is off.
 };
 
 inline bool Global_Classic::is_initialized()
@@ -41,6 +52,34 @@ inline void Global_Classic::print_params()
     this->gclc_in_mpreal->print_params();
 }
 
+inline int Global_Classic::get_swap_iteration()
+{
+    return this->gclc_in_double->get_swap_iteration();
+}
+
+inline double Global_Classic::get_swap_value()
+{
+    return this->gclc_in_double->get_swap_value();
+}
+
+inline int Global_Classic::get_dd_swap_iteration()
+{
+    // The iteration of the swap from dd_real to mpreal, -1 if there was none
+    // (the dd_real tier is off, or the last run did not reach it).
+
+    if (this->gclc_in_dd == nullptr || this->gclc_in_double->get_swap_iteration() == -1)
+    {
+        return -1;
+    }
+
+    return this->gclc_in_dd->get_swap_iteration();
+}
+
+inline double Global_Classic::get_dd_swap_value()
+{
+    return (this->get_dd_swap_iteration() == -1) ? 0 : this->gclc_in_dd->get_swap_value();
+}
+
 Global_Classic *Global_Classic_Init(pso_params<MP_REAL, MPFR_ARR> &p, double swap_point, int precision = 64,
                                     std::ostream *output = &(std::cout));
 
@@ -15,59 +15,21 @@ class Global_Classic_Internal : public PSO<Type, Type_Arr, Type_Vec, Type_Empty>
     {
         bool success = false;
 
-        Type_Empty empty;
-        this->result = empty;
-
-        if (this->var_type == "mp_real")
-        {
-            // If the variable type is mp_real, set the swap point to the global minimum.
-            // This allows the program to converge and exit.
-            // If the variable type is double, then the program exits at the swap point
-            // set by the user.
-
-            swap_point = double(this->p.gm);
-        }
-
-        if (this->Obj_F == nullptr)
+        if (this->fit_begin(swap_point) == false)
         {
-            (*this->output) << "~> Error: Objective Function was not declared." << std::endl;
-
-            return empty;
+            return this->result;
         }
 
-        this->fpopul = Type_Vec(this->p.popsize);
-
-        this->initialize_arrays();
         this->evaluate_swarm("initial");
 
-        if (this->check_initial_particles() == false)
+        if (this->fit_initial_check() == false)
         {
-            // If all the particles have out-of-bounds energy, return this error.
-
-            (*this->output) << "Error: All initial particles are not suitable." << std::endl;
-
             return this->result;
         }
 
         this->swarm_evolution(success, swap_point);
 
-        if (success == true)
-        {
-            // If an orbit is found, save it.
-
-            this->save_minima(this->obj_calculate(this->bestpos.col(this->g)));
-
-            (*this->output) << "|---------------- " << std::endl;
-            (*this->output) << "- Orbit   Found - " << std::endl;
-            (*this->output) << "|---------------- " << std::endl;
-        }
-
-        if (swap_point - double(this->p.gm) <= double(this->p.gm) * 10)
-        {
-            this->obj_print_result(this->result);
-        }
-
-        return this->result;
+        return this->fit_end(success, swap_point);
     }
 };
 
@@ -1,8 +1,18 @@
 #ifndef __PSO__
 #define __PSO__
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../checkpoint/checkpoint.hpp"
 #include "../functions/functions.hpp"
+#include "../mp_arena/mp_arena.hpp"
 #include "../objective_functions/objective_functions.hpp"
+#include "../telemetry/telemetry.hpp"
 
 template <typename Type, typename Type_Arr> struct pso_params
 {
@@ -21,6 +31,26 @@ template <typename Type, typename Type_Arr> struct pso_params
     Type min_w = 0.01;
     Type err_goal = 1e-5;
     double swap_point;
+    uint64_t seed = 0;   // Seed of the random engine. If 0, the run is not reproducible.
+    uint64_t stream = 0; // The random stream of the swarm (e.g. the grid cell).
+    bool fixed_dim = true; // Use the compile-time dimension kernels if 1 <= dim <= 4.
+    int async_threads = 0; // If > 0, run the asynchronous PSO with this many evaluation workers.
+    telemetry_params tp;   // The settings of the iteration output.
+    int stall_it = 0;                     // Iterations without improvement before the swarm is stagnant (0: off).
+    double stall_tol = 1e-3;              // The relative improvement of the best fitness that counts as progress.
+    double stall_diameter = 0;            // A swarm smaller than this (relative to the bounds) is stagnant.
+    double restart_frac = 0.5;            // The fraction of the population that is re-seeded on stagnation.
+    std::string stall_action = "restart"; // "restart" (partial restart) or "abort" on stagnation.
+    bool auto_swap = false;               // Swap to mpreal when the double swarm runs out of precision.
+    int swap_window = 50;                 // Iterations of rounding-level improvement before the automatic swap.
+    double swap_ulps = 16;                // The number of ULPs that is considered rounding noise.
+    std::string checkpoint = "";          // The checkpoint file of the run ("": no checkpoints).
+    int checkpoint_every = 100;           // Iterations between checkpoints.
+    bool dd_tier = false;                 // Continue in double-double between the double and mpreal models.
+    double dd_swap_point = 0;             // The swap point from double-double to mpreal.
+    int elite = 0;                        // Continue only the best particles in mpreal (0: the whole swarm).
+    int newton_it = 0;                    // Newton steps on the best particle at the swap (0: off).
+    double tol_ratio = 0;                 // The ODE tolerance relative to the best error (0: full accuracy).
     Type_Arr bounds;
 };
 
@@ -32,6 +62,8 @@ struct variables
     // model.
 
     int iter;
+    long evaluations; // The number of objective function evaluations so far.
+    double wall_time; // The time spent so far (seconds).
     MPFR_ARR vel;
     MPFR_ARR popul;
     MPFR_VEC fpopul;
@@ -41,8 +73,117 @@ struct variables
     Eigen::Index g;
 };
 
+inline bool checkpoint_save(std::string file, const variables &v, std::string var_type, int run)
+{
+    // Save the state of a run. var_type is the model that wrote the checkpoint
+    // and run is the progress of the algorithm (e.g. the run of deflection).
+
+    checkpoint_writer w(file);
+
+    w.write(var_type);
+    w.write(run);
+    w.write(v.iter);
+    w.write(v.evaluations);
+    w.write(v.wall_time);
+    w.write(long(v.g));
+    w.write(v.vel);
+    w.write(v.popul);
+    w.write(v.fpopul);
+    w.write(v.result);
+    w.write(v.bestpos);
+    w.write(v.fbestpos);
+
+    return w.close();
+}
+
+inline bool checkpoint_load(std::string file, variables &v, std::string &var_type, int &run)
+{
+    // Load the state of a run saved by checkpoint_save().
+    // Returns false if there is no (valid) checkpoint.
+
+    long g = 0;
+    checkpoint_reader r(file);
+
+    r.read(var_type);
+    r.read(run);
+    r.read(v.iter);
+    r.read(v.evaluations);
+    r.read(v.wall_time);
+    r.read(g);
+    r.read(v.vel);
+    r.read(v.popul);
+    r.read(v.fpopul);
+    r.read(v.result);
+    r.read(v.bestpos);
+    r.read(v.fbestpos);
+
+    v.g = g;
+
+    return r.is_good() && (var_type == "double" || var_type == "dd_real" || var_type == "mp_real");
+}
+
+inline void select_elite(variables &v, int elite)
+{
+    // Keep only the elite particles (the best ones by their best fitness) of
+    // an exported swarm, so that only they are refined in mpreal. The other
+    // particles are dropped. The particles keep their order and the global
+    // best particle is always kept.
+
+    int popsize = int(v.popul.cols());
+
+    if (elite <= 0 || elite >= popsize || v.fpopul.size() != popsize || v.fbestpos.size() != popsize)
+    {
+        return;
+    }
+
+    std::vector<int> order(popsize);
+
+    for (int i = 0; i < popsize; i++)
+    {
+        order[i] = i;
+    }
+
+    std::partial_sort(order.begin(), order.begin() + elite, order.end(), [&](int a, int b) {
+        if (a == v.g || b == v.g)
+        {
+            return a == v.g && b != v.g;
+        }
+
+        return v.fbestpos(a) < v.fbestpos(b);
+    });
+    std::sort(order.begin(), order.begin() + elite);
+
+    Eigen::Index g = 0;
+    MPFR_ARR vel(v.vel.rows(), elite);
+    MPFR_ARR popul(v.popul.rows(), elite);
+    MPFR_VEC fpopul(elite);
+    MPFR_ARR bestpos(v.bestpos.rows(), elite);
+    MPFR_VEC fbestpos(elite);
+
+    for (int k = 0; k < elite; k++)
+    {
+        vel.col(k).swap(v.vel.col(order[k]));
+        popul.col(k).swap(v.popul.col(order[k]));
+        std::swap(fpopul(k), v.fpopul(order[k]));
+        bestpos.col(k).swap(v.bestpos.col(order[k]));
+        std::swap(fbestpos(k), v.fbestpos(order[k]));
+
+        if (order[k] == v.g)
+        {
+            g = k;
+        }
+    }
+
+    v.vel.swap(vel);
+    v.popul.swap(popul);
+    v.fpopul.swap(fpopul);
+    v.bestpos.swap(bestpos);
+    v.fbestpos.swap(fbestpos);
+    v.g = g;
+}
+
 template <typename Type, typename Type_Arr>
-pso_params<MP_REAL, MPFR_ARR> pso_params_to_mpfr(pso_params<Type, Type_Arr> params)
+pso_params<MP_REAL, MPFR_ARR> pso_params_to_mpfr(const pso_params<Type, Type_Arr> &params)
 {
     pso_params<MP_REAL, MPFR_ARR> mpfr_params;
 
@@ -55,13 +196,33 @@ pso_params<MP_REAL, MPFR_ARR> pso_params_to_mpfr(pso_params<Type, Type_Arr> para
     mpfr_params.max_w = MP_REAL(params.max_w);
     mpfr_params.min_w = MP_REAL(params.min_w);
     mpfr_params.err_goal = MP_REAL(params.err_goal);
+    mpfr_params.seed = params.seed;
+    mpfr_params.stream = params.stream;
+    mpfr_params.fixed_dim = params.fixed_dim;
+    mpfr_params.async_threads = params.async_threads;
+    mpfr_params.tp = params.tp;
+    mpfr_params.stall_it = params.stall_it;
+    mpfr_params.stall_tol = params.stall_tol;
+    mpfr_params.stall_diameter = params.stall_diameter;
+    mpfr_params.restart_frac = params.restart_frac;
+    mpfr_params.stall_action = params.stall_action;
+    mpfr_params.auto_swap = params.auto_swap;
+    mpfr_params.swap_window = params.swap_window;
+    mpfr_params.swap_ulps = params.swap_ulps;
+    mpfr_params.checkpoint = params.checkpoint;
+    mpfr_params.checkpoint_every = params.checkpoint_every;
+    mpfr_params.dd_tier = params.dd_tier;
+    mpfr_params.dd_swap_point = params.dd_swap_point;
+    mpfr_params.elite = params.elite;
+    mpfr_params.newton_it = params.newton_it;
+    mpfr_params.tol_ratio = params.tol_ratio;
     mpfr_params.bounds = double_to_mpfr_ARR(params.bounds);
 
     return mpfr_params;
 }
 
 template <typename Type, typename Type_Arr>
-pso_params<double, DOUBLE_ARR> pso_params_to_double(pso_params<Type, Type_Arr> params)
+pso_params<double, DOUBLE_ARR> pso_params_to_double(const pso_params<Type, Type_Arr> &params)
 {
     pso_params<double, DOUBLE_ARR> double_params;
 
@@ -74,13 +235,76 @@ pso_params<double, DOUBLE_ARR> pso_params_to_double(pso_params<Type, Type_Arr> p
     double_params.max_w = double(params.max_w);
     double_params.min_w = double(params.min_w);
     double_params.err_goal = double(params.err_goal);
+    double_params.seed = params.seed;
+    double_params.stream = params.stream;
+    double_params.fixed_dim = params.fixed_dim;
+    double_params.async_threads = params.async_threads;
+    double_params.tp = params.tp;
+    double_params.stall_it = params.stall_it;
+    double_params.stall_tol = params.stall_tol;
+    double_params.stall_diameter = params.stall_diameter;
+    double_params.restart_frac = params.restart_frac;
+    double_params.stall_action = params.stall_action;
+    double_params.auto_swap = params.auto_swap;
+    double_params.swap_window = params.swap_window;
+    double_params.swap_ulps = params.swap_ulps;
+    double_params.checkpoint = params.checkpoint;
+    double_params.checkpoint_every = params.checkpoint_every;
+    double_params.dd_tier = params.dd_tier;
+    double_params.dd_swap_point = params.dd_swap_point;
+    double_params.elite = params.elite;
+    double_params.newton_it = params.newton_it;
+    double_params.tol_ratio = params.tol_ratio;
     double_params.bounds = mpfr_to_double_ARR(params.bounds);
 
     return double_params;
 }
 
+template <typename Type, typename Type_Arr>
+pso_params<DD_REAL, DD_ARR> pso_params_to_dd(const pso_params<Type, Type_Arr> &params)
+{
+    pso_params<DD_REAL, DD_ARR> dd_params;
+
+    dd_params.dim = params.dim;
+    dd_params.max_it = params.max_it;
+    dd_params.popsize = params.popsize;
+    dd_params.c1 = DD_REAL(params.c1);
+    dd_params.c2 = DD_REAL(params.c2);
+    dd_params.gm = DD_REAL(params.gm);
+    dd_params.max_w = DD_REAL(params.max_w);
+    dd_params.min_w = DD_REAL(params.min_w);
+    dd_params.err_goal = DD_REAL(params.err_goal);
+    dd_params.seed = params.seed;
+    dd_params.stream = params.stream;
+    dd_params.fixed_dim = params.fixed_dim;
+    dd_params.async_threads = params.async_threads;
+    dd_params.tp = params.tp;
+    dd_params.stall_it = params.stall_it;
+    dd_params.stall_tol = params.stall_tol;
+    dd_params.stall_diameter = params.stall_diameter;
+    dd_params.restart_frac = params.restart_frac;
+    dd_params.stall_action = params.stall_action;
+    dd_params.auto_swap = params.auto_swap;
+    dd_params.swap_window = params.swap_window;
+    dd_params.swap_ulps = params.swap_ulps;
+    dd_params.checkpoint = params.checkpoint;
+    dd_params.checkpoint_every = params.checkpoint_every;
+    dd_params.dd_tier = params.dd_tier;
+    dd_params.dd_swap_point = params.dd_swap_point;
+    dd_params.elite = params.elite;
+    dd_params.newton_it = params.newton_it;
+    dd_params.tol_ratio = params.tol_ratio;
+    dd_params.bounds = params.bounds.template cast<DD_REAL>();
+
+    return dd_params;
+}
+
+template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Empty> class Batch_Internal;
+
 template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Empty> class PSO
 {
+    friend class Batch_Internal<Type, Type_Arr, Type_Vec, Type_Empty>; // Steps the swarm in lockstep with others.
+
   public:
     PSO(const pso_params<Type, Type_Arr> &p, std::string var_type, int precision, std::ostream *output)
     {
@@ -90,7 +314,25 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         this->result = Type_Arr(0, 0);
         this->output = output;
         this->imported = false;
+        this->evaluations = 0;
+        this->run = 0;
+        this->swap_iter = -1;
+        this->swap_value = 0;
+        this->tel = new telemetry(this->p.tp, output);
         this->var_type = var_type;
+        this->precision = precision;
+
+        // The swarm kernels are instantiated for a compile-time dimension
+        // of 1 to 4 (fixed-size Eigen columns, unrolled loops). Any other
+        // dimension uses the Eigen::Dynamic instantiation.
+        if (this->p.fixed_dim == true && this->p.dim >= 1 && this->p.dim <= 4)
+        {
+            this->kernel_dim = this->p.dim;
+        }
+        else
+        {
+            this->kernel_dim = Eigen::Dynamic;
+        }
 
         if (precision < 64)
         {
@@ -98,6 +340,16 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
             (*this->output) << "Default precision set to 64." << std::endl;
 
             precision = 64;
+            this->precision = 64;
+        }
+
+        if (this->p.dd_tier == true && precision <= 106)
+        { // The dd_real values (106 bits) are handed over to MPFR and checkpointed through it.
+            (*this->output) << "The double-double tier needs a MP-Real precision greater than 106." << std::endl;
+            (*this->output) << "Default precision set to 128." << std::endl;
+
+            precision = 128;
+            this->precision = 128;
         }
 
         if (this->p.dim <= 0)
@@ -131,6 +383,9 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
 
     virtual ~PSO()
     {
+        delete this->tel;
+        this->tel = nullptr;
+
         if (this->Obj_F != nullptr)
         {
             delete this->Obj_F;
@@ -138,28 +393,67 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         }
     }
 
-    void var_import(variables v)
+    void var_import(const variables &v)
     {
         // A function that uses a variables structure to import
-        // essential variables to continue the execution with MPFR variables.
+        // essential variables to continue the execution with MPFR variables
+        // (or to resume the execution from a checkpoint). The arrays are
+        // converted into the existing arrays of the model.
 
         this->iter = v.iter;
-        this->vel = v.vel;
-        this->popul = v.popul;
-        this->fpopul = v.fpopul;
-        this->save_minima(v.result);
-        this->bestpos = v.bestpos;
-        this->fbestpos = v.fbestpos;
+        this->evaluations = v.evaluations;
+        this->tel->resume(v.wall_time);
+        this->p.popsize = int(v.popul.cols()); // Smaller than the swarm after select_elite().
+        cast_into(v.vel, this->vel);
+        cast_into(v.popul, this->popul);
+        cast_into(v.fpopul, this->fpopul);
+        this->save_minima(v.result.template cast<Type>());
+        cast_into(v.bestpos, this->bestpos);
+        cast_into(v.fbestpos, this->fbestpos);
         this->g = v.g;
 
         this->imported = true;
     }
 
+    void var_import(variables &&v)
+    {
+        // The same, for a structure that is not needed afterwards. The mpreal
+        // model takes the arrays instead of copying them, v gets the old
+        // arrays of the model, so its storage can be reused by var_export().
+
+        if constexpr (std::is_same_v<Type, MP_REAL>)
+        {
+            this->iter = v.iter;
+            this->evaluations = v.evaluations;
+            this->tel->resume(v.wall_time);
+            this->p.popsize = int(v.popul.cols()); // Smaller than the swarm after select_elite().
+            this->vel.swap(v.vel);
+            this->popul.swap(v.popul);
+            this->fpopul.swap(v.fpopul);
+            this->save_minima(v.result);
+            this->bestpos.swap(v.bestpos);
+            this->fbestpos.swap(v.fbestpos);
+            this->g = v.g;
+
+            this->imported = true;
+        }
+        else
+        {
+            this->var_import(static_cast<const variables &>(v));
+        }
+    }
+
     void set_Obj_F(std::string objective_func, const obj_params<Type> &params)
     {
         this->Obj_F = new Objective_Functions<Type, Type_Arr, Type_Vec, Type_Empty>(this->output);
 
         this->Obj_F->init(params, objective_func);
+
+        if (this->p.async_threads > 0)
+        { // The asynchronous workers already evaluate in parallel, so every
+          // evaluation runs on one thread (not async_threads * threads).
+            this->Obj_F->set_threads(1);
+        }
     }
 
     variables var_export()
@@ -169,16 +463,63 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
 
         variables v;
 
+        this->var_export(v);
+
+        return v;
+    }
+
+    void var_export(variables &v)
+    {
+        // The same, into an existing structure. Its arrays are reused when
+        // they have the shape of the swarm (e.g. on the next run of deflection).
+
         v.iter = this->iter;
-        v.vel = double_to_mpfr_ARR(this->vel);
-        v.popul = double_to_mpfr_ARR(this->popul);
-        v.fpopul = double_to_mpfr_VEC(this->fpopul);
-        v.result = double_to_mpfr_ARR(this->result);
-        v.bestpos = double_to_mpfr_ARR(this->bestpos);
-        v.fbestpos = double_to_mpfr_VEC(this->fbestpos);
+        v.evaluations = this->evaluations;
+        v.wall_time = this->tel->elapsed();
+        cast_into(this->vel, v.vel);
+        cast_into(this->popul, v.popul);
+        cast_into(this->fpopul, v.fpopul);
+        cast_into(this->result, v.result);
+        cast_into(this->bestpos, v.bestpos);
+        cast_into(this->fbestpos, v.fbestpos);
         v.g = this->g;
+    }
 
-        return v;
+    inline std::string get_status()
+    {
+        // The status of the last run: "converged", "max_it", "swap" (the swap
+        // point was reached) or "stagnated" (aborted by the convergence monitor).
+
+        return this->status;
+    }
+
+    inline void set_run(int run)
+    {
+        // The progress of the algorithm that is saved in the checkpoints.
+
+        this->run = run;
+    }
+
+    inline void clear_telemetry()
+    {
+        // Empty the file of the telemetry records, at the start of a new run.
+
+        this->tel->clear();
+    }
+
+    inline int get_swap_iteration()
+    {
+        // The iteration of the last swap to the next model (dd_real or mp_real),
+        // -1 if there was none.
+
+        return this->swap_iter;
+    }
+
+    inline double get_swap_value()
+    {
+        // The best value of the swarm at the last swap to the next model.
+
+        return this->swap_value;
     }
 
     virtual bool parameter_check()
@@ -216,6 +557,73 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
 
             return false;
         }
+        else if (this->p.async_threads < 0)
+        {
+            std::cout << "~> Error: The number of asynchronous workers cannot be negative." << std::endl;
+
+            return false;
+        }
+        else if (this->p.stall_it < 0 || this->p.stall_diameter < 0)
+        {
+            std::cout << "~> Error: The stagnation iterations and diameter cannot be negative." << std::endl;
+
+            return false;
+        }
+        else if (this->p.restart_frac <= 0 || this->p.restart_frac > 1)
+        {
+            std::cout << "~> Error: The restart fraction should be greater than 0 and smaller or equal to 1."
+                      << std::endl;
+
+            return false;
+        }
+        else if (this->p.stall_action != "restart" && this->p.stall_action != "abort")
+        {
+            std::cout << "~> Error: The stagnation action should be [restart] or [abort]." << std::endl;
+
+            return false;
+        }
+        else if (this->p.swap_window < 1 || this->p.swap_ulps <= 0)
+        {
+            std::cout << "~> Error: The swap window should be at least 1 and the swap ULPs greater than 0."
+                      << std::endl;
+
+            return false;
+        }
+        else if (this->p.elite < 0)
+        {
+            std::cout << "~> Error: The number of elite particles cannot be negative." << std::endl;
+
+            return false;
+        }
+        else if (this->p.newton_it < 0)
+        {
+            std::cout << "~> Error: The number of Newton steps cannot be negative." << std::endl;
+
+            return false;
+        }
+        else if (this->p.tol_ratio < 0)
+        {
+            std::cout << "~> Error: The tolerance ratio cannot be negative." << std::endl;
+
+            return false;
+        }
+        else if (this->p.tol_ratio > 0 && this->p.async_threads > 0)
+        {
+            std::cout << "~> Error: The tolerance schedule (tol_ratio) cannot be used with the asynchronous PSO."
+                      << std::endl;
+
+            return false;
+        }
+        else if (this->p.checkpoint_every < 1)
+        {
+            std::cout << "~> Error: The iterations between checkpoints should be at least 1." << std::endl;
+
+            return false;
+        }
+        else if (telemetry::check_params(this->p.tp) == false)
+        {
+            return false;
+        }
         else if (this->p.max_w <= this->p.min_w)
         {
             std::cout << "~> Error: The maximum weight value must be greater than the minimum (max_w > min_w)."
@@ -260,6 +668,9 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
 
   protected:
     int iter;
+    long evaluations; // The number of objective function evaluations.
+    int precision;  // The default MPFR precision (needed by the asynchronous workers).
+    int kernel_dim; // The compile-time dimension of the swarm kernels.
     bool imported;
     Type_Arr vel;
     Type_Arr popul;
@@ -268,14 +679,100 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
     Type_Arr bestpos;
     Type_Vec fbestpos;
     Type_Arr vel_bounds;
+    Type_Arr R1; // Workspace for the random coefficients of c1.
+    Type_Arr R2; // Workspace for the random coefficients of c2.
+    mp_arena scratch; // Workspace for the temporaries of the MPFR kernels.
     std::string var_type;
+    std::string status;        // The status of the last run (see get_status()).
+    std::vector<bool> reseed;  // The particles marked for a restart.
+    int stall_count;           // Iterations without improvement.
+    Type stall_best;           // The best fitness at the last improvement.
+    int run;           // The progress of the algorithm (saved in the checkpoints).
+    int swap_iter;     // The iteration of the swap to the mpreal model.
+    double swap_value; // The best value at the swap.
+    Type swap_ref;     // The best value at the last improvement.
+    int swap_count;    // Rounding-level improvements since the last larger one.
+    Type w;        // The inertia weight.
+    Type weveryit; // The iterations over which the inertia weight decreases.
+    Type inertdec; // The decrease of the inertia weight per iteration.
     Eigen::Index g;
     std::ostream *output;
+    telemetry *tel; // The iteration output.
 
     pso_params<Type, Type_Arr> p;
 
     Objective_Functions<Type, Type_Arr, Type_Vec, Type_Empty> *Obj_F;
 
+    bool fit_begin(double &swap_point)
+    {
+        // Prepare a run of fit(). Returns false if the run cannot start.
+
+        Type_Empty empty;
+        this->result = empty;
+
+        if (this->var_type == "mp_real")
+        {
+            // If the variable type is mp_real, set the swap point to the global minimum.
+            // This allows the program to converge and exit.
+            // If the variable type is double, then the program exits at the swap point
+            // set by the user.
+
+            swap_point = double(this->p.gm);
+        }
+
+        if (this->Obj_F == nullptr)
+        {
+            (*this->output) << "~> Error: Objective Function was not declared." << std::endl;
+
+            return false;
+        }
+
+        this->fpopul = Type_Vec(this->p.popsize);
+
+        this->initialize_arrays();
+
+        return true;
+    }
+
+    bool fit_initial_check()
+    {
+        // Called after the initial evaluation of the swarm.
+
+        if (this->check_initial_particles() == false)
+        {
+            // If all the particles have out-of-bounds energy, return this error.
+
+            (*this->output) << "Error: All initial particles are not suitable." << std::endl;
+
+            return false;
+        }
+
+        return true;
+    }
+
+    Type_Arr fit_end(bool success, double swap_point)
+    {
+        // Save and print the result of a run of fit().
+
+        if (success == true)
+        {
+            // If an orbit is found, save it.
+
+            this->save_minima(this->obj_calculate(this->bestpos.col(this->g)));
+
+            (*this->output) << "|---------------- " << std::endl;
+            (*this->output) << "- Orbit   Found - " << std::endl;
+            (*this->output) << "|---------------- " << std::endl;
+        }
+
+        if (swap_point - double(this->p.gm) <= double(this->p.gm) * 10)
+        {
+            this->obj_print_result(this->result);
+        }
+
+        return this->result;
+    }
+
     bool check_initial_particles()
     {
         // Returns false if all particles' energies are out-of-bound.
@@ -293,23 +790,190 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         return ((inf_count == this->fpopul.size()) ? false : true);
     }
 
-    void vel_clamp()
+    template <typename Kernel> void dispatch_dim(Kernel kernel)
     {
-        // A function that prevents the explosion of particle values
-        // using the velocity boundaries as explained in the constructor.
+        // Call the kernel with the compile-time dimension that was
+        // selected in the constructor.
+
+        switch (this->kernel_dim)
+        {
+        case 1:
+            kernel(std::integral_constant<int, 1>());
+            break;
+        case 2:
+            kernel(std::integral_constant<int, 2>());
+            break;
+        case 3:
+            kernel(std::integral_constant<int, 3>());
+            break;
+        case 4:
+            kernel(std::integral_constant<int, 4>());
+            break;
+        default:
+            kernel(std::integral_constant<int, Eigen::Dynamic>());
+            break;
+        }
+    }
 
-        Type_Arr clamped(this->p.dim, this->p.popsize);
+    template <int Dim> void move_particle(int i, const Type &w, const Type *con, const Type *attractor)
+    {
+        // The fused step of one particle: velocity update, velocity clamp,
+        // constriction (if con is not nullptr) and position update, in a
+        // single pass over the (contiguous) column of the particle.
+        // The velocity boundaries prevent the explosion of particle values,
+        // as explained in the constructor.
 
-        for (int i = 0; i < this->p.dim; i++)
+        if constexpr (std::is_same_v<Type, MP_REAL>)
+        {
+            // In MPFR, every operation of the Eigen expression would construct
+            // a temporary number (an allocation), so the step runs in place.
+            this->move_particle_mpfr(i, w, con, attractor);
+        }
+        else
+        {
+            typedef Eigen::Array<Type, Dim, 1> Col;
+
+            int dim = this->p.dim;
+
+            Eigen::Map<Col> v(this->vel.col(i).data(), dim);
+            Eigen::Map<Col> x(this->popul.col(i).data(), dim);
+            Eigen::Map<const Col> b(this->bestpos.col(i).data(), dim);
+            Eigen::Map<const Col> s(attractor, dim);
+            Eigen::Map<const Col> r1(this->R1.col(i).data(), dim);
+            Eigen::Map<const Col> r2(this->R2.col(i).data(), dim);
+            Eigen::Map<const Col> lo(this->vel_bounds.col(0).data(), dim);
+            Eigen::Map<const Col> hi(this->vel_bounds.col(1).data(), dim);
+
+            v = (w * v + this->p.c1 * r1 * (b - x) + this->p.c2 * r2 * (s - x)).cwiseMax(lo).cwiseMin(hi);
+
+            if (con != nullptr)
+            {
+                v *= *con;
+            }
+
+            x += v;
+        }
+    }
+
+    void move_particle_mpfr(int i, const Type &w, const Type *con, const Type *attractor)
+    {
+        // The fused step of move_particle() with the in-place MPFR functions and
+        // the temporaries in the scratch arena. The operations are the ones of
+        // the Eigen expression, in the same order, so the result is the same.
+
+        mpfr_ptr t0 = this->scratch(0);
+        mpfr_ptr t1 = this->scratch(1);
+        mpfr_ptr t2 = this->scratch(2);
+
+        for (int k = 0; k < this->p.dim; k++)
         {
-            clamped.row(i) = this->vel.row(i).cwiseMax(this->vel_bounds(i, 0)).cwiseMin(this->vel_bounds(i, 1));
+            mpfr_ptr v = this->vel(k, i).mpfr_ptr();
+            mpfr_ptr x = this->popul(k, i).mpfr_ptr();
+
+            // w * v + c1 * r1 * (b - x)
+            mpfr_mul(t2, w.mpfr_srcptr(), v, MPFR_RNDN);
+            mpfr_mul(t0, this->p.c1.mpfr_srcptr(), this->R1(k, i).mpfr_srcptr(), MPFR_RNDN);
+            mpfr_sub(t1, this->bestpos(k, i).mpfr_srcptr(), x, MPFR_RNDN);
+            mpfr_mul(t0, t0, t1, MPFR_RNDN);
+            mpfr_add(t2, t2, t0, MPFR_RNDN);
+
+            // + c2 * r2 * (s - x)
+            mpfr_mul(t0, this->p.c2.mpfr_srcptr(), this->R2(k, i).mpfr_srcptr(), MPFR_RNDN);
+            mpfr_sub(t1, attractor[k].mpfr_srcptr(), x, MPFR_RNDN);
+            mpfr_mul(t0, t0, t1, MPFR_RNDN);
+            mpfr_add(v, t2, t0, MPFR_RNDN);
+
+            // The velocity clamp.
+            if (mpfr_less_p(v, this->vel_bounds(k, 0).mpfr_srcptr()))
+            {
+                mpfr_set(v, this->vel_bounds(k, 0).mpfr_srcptr(), MPFR_RNDN);
+            }
+
+            if (mpfr_greater_p(v, this->vel_bounds(k, 1).mpfr_srcptr()))
+            {
+                mpfr_set(v, this->vel_bounds(k, 1).mpfr_srcptr(), MPFR_RNDN);
+            }
+
+            if (con != nullptr)
+            {
+                mpfr_mul(v, v, con->mpfr_srcptr(), MPFR_RNDN);
+            }
+
+            mpfr_add(x, x, v, MPFR_RNDN);
+        }
+    }
+
+    template <int Dim> void swarm_kernel(const Type &w)
+    {
+        // Move every particle towards its social attractor.
+
+        const Type *con = this->constriction_coeff();
+
+        for (int i = 0; i < this->p.popsize; i++)
+        {
+            this->template move_particle<Dim>(i, w, con, this->social_attractor(i));
+        }
+    }
+
+    virtual const Type *social_attractor(int i)
+    {
+        // The social attractor of a particle. By default it is the
+        // global best particle.
+
+        return this->bestpos.col(this->g).data();
+    }
+
+    virtual const Type *constriction_coeff()
+    {
+        // The constriction coefficient, or nullptr if the velocity is
+        // not constricted.
+
+        return nullptr;
+    }
+
+    virtual void neighbourhood_update()
+    {
+        // Recalculate the social attractors of the particles, if they
+        // depend on the current population. Nothing to do for the global best.
+    }
+
+    template <int Dim> void update_best()
+    {
+        // Save the particles that improved their best position.
+
+        typedef Eigen::Array<Type, Dim, 1> Col;
+
+        int dim = this->p.dim;
+
+        for (int i = 0; i < this->fpopul.rows(); i++)
+        {
+            if (this->fpopul(i) < this->fbestpos(i))
+            {
+                this->fbestpos(i) = this->fpopul(i);
+                Eigen::Map<Col>(this->bestpos.col(i).data(), dim) = Eigen::Map<const Col>(this->popul.col(i).data(), dim);
+            }
         }
+    }
+
+    virtual void allocate_workspace()
+    {
+        // Allocate the arrays that are reused by every iteration,
+        // once per fit().
+
+        this->R1 = Type_Arr(this->p.dim, this->p.popsize);
+        this->R2 = Type_Arr(this->p.dim, this->p.popsize);
+        this->reseed.assign(this->p.popsize, false);
 
-        this->vel = clamped;
+        if constexpr (std::is_same_v<Type, MP_REAL>)
+        {
+            this->scratch.resize(3, 1, this->precision);
+        }
     }
 
     void initialize_arrays()
     {
+        this->allocate_workspace();
+
         if (this->imported == true)
         {
             return;
@@ -317,9 +981,15 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
 
         Type_Empty empty;
 
+        this->evaluations = 0;
+        this->tel->restart();
+
         // Initialize velocity and population randomly with the U(0,1) distribution.
-        this->vel = Type_Arr::NullaryExpr(this->p.dim, this->p.popsize, [&]() { return Type(uniform_real(0, 1)); });
-        this->popul = Type_Arr::NullaryExpr(this->p.dim, this->p.popsize, [&]() { return Type(uniform_real(0, 1)); });
+        this->vel = Type_Arr(this->p.dim, this->p.popsize);
+        this->popul = Type_Arr(this->p.dim, this->p.popsize);
+
+        uniform_real_fill(this->vel, 0, 1);
+        uniform_real_fill(this->popul, 0, 1);
 
         // Apply dimensional limits for the population.
         for (int i = 0; i < this->p.dim; i++)
@@ -332,7 +1002,7 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         this->fbestpos = empty;
     }
 
-    void save_minima(Type_Arr min)
+    void save_minima(const Type_Arr &min)
     {
         // Expands the result array to save a new minimum that is found.
 
@@ -360,83 +1030,810 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
 
     void swarm_evolution(bool &success, double swap_point)
     {
-        if (this->imported == false)
+        this->begin_evolution();
+
+        if (this->imported == true && this->var_type == "mp_real")
         {
-            this->iter = 0;
+            // Polish the imported best particle in mpreal, before the swarm moves.
+            this->newton_refine();
+            this->check_stop_criterion(success);
         }
 
-        Type w = this->p.max_w;
-        Type weveryit = lmath::floor(0.75 * this->p.max_it);
-        Type inertdec = (this->p.max_w - this->p.min_w) / weveryit;
-
-        // Swarm evolution loop.
-        while ((success == false) && (this->iter < this->p.max_it))
+        if (this->p.async_threads > 0)
         {
-            if (swap_point > this->fbestpos(g))
-            {
-                return;
-            }
-
-            this->iter++;
+            this->swarm_evolution_async(success, swap_point);
 
-            // Update the value of the inertia weight w.
-            if (this->iter <= weveryit)
-            {
-                w = this->p.max_w - (this->iter - 1) * inertdec;
-            }
+            return;
+        }
 
-            this->velocity_update(w);
-            this->swarm_update();
+        // Swarm evolution loop.
+        while (this->evolution_running(success, swap_point) == true)
+        {
+            this->advance_swarm();
             this->evaluate_swarm();
-            this->check_stop_criterion(success);
-
-            (*this->output) << "|----------------- " << std::endl;
-            (*this->output) << "|- Iteration     : " << this->iter << std::endl;
-            (*this->output) << "|- Error         : " << this->fbestpos(g) << std::endl;
-            (*this->output) << "|- Best Particle : " << this->bestpos.col(g).transpose() << std::endl;
-            (*this->output) << "|----------------- " << std::endl;
+            this->finish_iteration(success);
+        }
+
+        if (this->status != "swap")
+        {
+            this->end_evolution(success);
+        }
+    }
+
+    void begin_evolution()
+    {
+        if (this->imported == false)
+        {
+            this->iter = 0;
+        }
+
+        this->status = "running";
+        this->stall_count = 0;
+        this->stall_best = lmath::get_infinity<Type>();
+        this->swap_iter = -1;
+        this->swap_ref = lmath::get_infinity<Type>();
+        this->swap_count = 0;
+
+        this->w = this->p.max_w;
+        this->weveryit = lmath::floor(0.75 * this->p.max_it);
+        this->inertdec = (this->p.max_w - this->p.min_w) / this->weveryit;
+    }
+
+    bool evolution_running(bool success, double swap_point)
+    {
+        // Returns true while the swarm has to be advanced. A run that reaches
+        // the swap point is not ended, it continues in the other model.
+
+        if ((success == true) || (this->iter >= this->p.max_it) || (this->status == "stagnated"))
+        {
+            return false;
+        }
+
+        if (this->swap_reached(swap_point) == true)
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    bool swap_reached(double swap_point)
+    {
+        // Returns true (and reports the swap) if the swarm has to continue in the
+        // mpreal model. Called once per iteration.
+
+        std::string reason;
+
+        if (swap_point > this->fbestpos(g))
+        {
+            reason = "swap point";
+        }
+        else if ((reason = this->precision_exhausted()) == "")
+        {
+            return false;
+        }
+
+        this->set_swap(reason);
+
+        return true;
+    }
+
+    void set_swap(std::string reason)
+    {
+        this->status = "swap";
+        this->swap_iter = this->iter;
+        this->swap_value = double(this->fbestpos(g));
+
+        this->tel->flush();
+
+        std::string next = (this->var_type == "double" && this->p.dd_tier == true) ? "dd_real" : "mp_real";
+
+        (*this->output) << "|- Swap to " << next << " at iteration " << this->swap_iter << ", best value "
+                        << this->swap_value << " (" << reason << ")." << '\n';
+
+        // Polish the best particle in this precision before it is handed over.
+        this->newton_refine();
+    }
+
+    void newton_refine()
+    {
+        // Polish the best particle with Newton steps on the objective function,
+        // if it supports them (the Poincare functions). The new position is kept
+        // only if it improves the fitness of the particle.
+
+        if (this->p.newton_it == 0 || this->g < 0 || this->fbestpos.size() == 0)
+        {
+            return;
+        }
+
+        Type_Vec x = this->bestpos.col(this->g);
+
+        if (this->Obj_F->refine(x, this->p.newton_it) == false)
+        {
+            return;
+        }
+
+        Type_Arr particle = x;
+        Type f = this->obj_function(particle)(0);
+
+        this->evaluations++;
+
+        if (f < this->fbestpos(this->g))
+        {
+            (*this->output) << "|- Newton refinement of the best particle in " << this->var_type << ", best value "
+                            << this->fbestpos(this->g) << " -> " << f << "." << '\n';
+
+            // The particle moves there as well (the enhanced swarms reset their
+            // best positions to the population on import).
+            this->bestpos.col(this->g) = x;
+            this->fbestpos(this->g) = f;
+            this->popul.col(this->g) = x;
+            this->fpopul(this->g) = f;
+        }
+    }
+
+    std::string precision_exhausted()
+    {
+        // The automatic swap point. The double (or double-double) swarm has run out
+        // of precision if its best value is at the rounding level of gm (of the best
+        // position, if gm = 0), if it has improved swap_window times at the rounding
+        // level of its best value since its last larger improvement, or if the best
+        // positions of all the particles are within a few ULPs of each other.
+        // Iterations without improvement (a plateau) do not count towards a swap.
+        // Returns the reason, or an empty string.
+
+        if (this->p.auto_swap == false || this->var_type == "mp_real")
+        {
+            return "";
+        }
+
+        double eps = (this->var_type == "dd_real") ? double(std::numeric_limits<DD_REAL>::epsilon())
+                                                   : std::numeric_limits<double>::epsilon();
+        double noise = this->p.swap_ulps * eps;
+        Type tiny = Type(std::numeric_limits<double>::min());
+        Type best = this->fbestpos(g);
+        Type gm = this->p.gm;
+
+        // The distance to gm, relative to gm or, if gm = 0 (e.g. the residual
+        // of the Poincare map), to the magnitude of the best position (at least 1).
+        Type scale = lmath::abs(gm);
+
+        if (gm == 0)
+        {
+            scale = 1;
+
+            for (int i = 0; i < this->p.dim; i++)
+            {
+                scale = std::max<Type>(scale, lmath::abs(this->bestpos(i, g)));
+            }
+        }
+
+        if (best - gm <= noise * scale)
+        {
+            return "distance to gm at rounding level";
+        }
+
+        // The relative improvement of the best value.
+        Type improvement = this->swap_ref - best;
+
+        if (improvement > noise * std::max<Type>(lmath::abs(best), tiny))
+        {
+            this->swap_ref = best;
+            this->swap_count = 0;
+        }
+        else if (improvement > 0)
+        { // (an improvement at the rounding level)
+            this->swap_ref = best;
+            this->swap_count++;
+        }
+
+        if (this->swap_count >= this->p.swap_window)
+        {
+            return "stalled improvement";
+        }
+
+        // The spread of the best positions.
+        for (int i = 0; i < this->p.dim; i++)
+        {
+            Type x = this->bestpos(i, g);
+            Type spread = this->bestpos.row(i).maxCoeff() - this->bestpos.row(i).minCoeff();
+
+            if (spread > noise * std::max<Type>(lmath::abs(x), tiny))
+            {
+                return "";
+            }
+        }
+
+        return "ULP-level spread of the best positions";
+    }
+
+    void advance_swarm()
+    {
+        this->iter++;
+
+        // Update the value of the inertia weight w.
+        if (this->iter <= this->weveryit)
+        {
+            this->w = this->p.max_w - (this->iter - 1) * this->inertdec;
+        }
+
+        this->velocity_update(this->w);
+        this->swarm_update();
+    }
+
+    void finish_iteration(bool &success)
+    {
+        // Everything that follows the evaluation of an iteration.
+
+        this->check_stop_criterion(success);
+
+        this->record_iteration();
+        this->save_checkpoint();
+
+        if (success == false)
+        {
+            this->check_stagnation(); // An abort sets the status to "stagnated".
+        }
+    }
+
+    void save_checkpoint()
+    {
+        // Save the state of the swarm every checkpoint_every iterations.
+
+        if (this->p.checkpoint == "" || this->iter % this->p.checkpoint_every != 0)
+        {
+            return;
+        }
+
+        if (checkpoint_save(this->p.checkpoint, this->var_export(), this->var_type, this->run) == false)
+        {
+            (*this->output) << "~> Error: The checkpoint " << this->p.checkpoint << " could not be written." << '\n';
+        }
+    }
+
+    void end_evolution(bool success)
+    {
+        // Set the status of a run that did not stop at the swap point.
+
+        if (success == true)
+        {
+            this->status = "converged";
+        }
+        else if (this->status != "stagnated")
+        {
+            this->status = "max_it";
+        }
+
+        this->tel->flush();
+
+        if (this->status == "stagnated")
+        {
+            (*this->output) << "~> The swarm stagnated, the run is aborted at iteration " << this->iter << "."
+                            << std::endl;
         }
 
         this->imported = false;
     }
 
-    virtual void swarm_update()
+    Type swarm_diameter()
+    {
+        // The largest extent of the population over all dimensions,
+        // relative to the size of the bounds of each dimension.
+
+        Type diameter = 0;
+
+        for (int i = 0; i < this->p.dim; i++)
+        {
+            Type extent = (this->popul.row(i).maxCoeff() - this->popul.row(i).minCoeff()) /
+                          (this->p.bounds(i, 1) - this->p.bounds(i, 0));
+
+            if (extent > diameter)
+            {
+                diameter = extent;
+            }
+        }
+
+        return diameter;
+    }
+
+    bool check_stagnation()
+    {
+        // The convergence monitor. It tracks the improvement of the best
+        // fitness and the diameter of the swarm. On stagnation, it either
+        // re-seeds part of the population (and returns false) or asks for
+        // the run to be aborted (and returns true).
+
+        if (this->p.stall_it <= 0)
+        {
+            return false;
+        }
+
+        Type best = this->fbestpos(this->g);
+
+        if (lmath::isinf(this->stall_best) || (this->stall_best - best) > this->p.stall_tol * lmath::abs(this->stall_best))
+        {
+            this->stall_best = best;
+            this->stall_count = 0;
+        }
+        else
+        {
+            this->stall_count++;
+        }
+
+        // A collapsed swarm that stopped improving cannot explore any more.
+        bool collapsed = (this->stall_count > 0) && (this->swarm_diameter() <= this->p.stall_diameter);
+
+        if (this->stall_count < this->p.stall_it && collapsed == false)
+        {
+            return false;
+        }
+
+        if (this->p.stall_action == "abort")
+        {
+            this->status = "stagnated";
+
+            return true;
+        }
+
+        this->restart_particles();
+        this->stall_count = 0;
+
+        return false;
+    }
+
+    void restart_particles()
+    {
+        // Re-seed the positions and velocities of the worst particles (by their
+        // best fitness). The best positions are kept, so the swarm does not
+        // lose what it found. The global best particle is never re-seeded.
+
+        int n = int(this->p.restart_frac * this->p.popsize);
+        std::vector<int> order(this->p.popsize);
+
+        for (int i = 0; i < this->p.popsize; i++)
+        {
+            order[i] = i;
+        }
+
+        std::partial_sort(order.begin(), order.begin() + n, order.end(),
+                          [&](int a, int b) { return this->fbestpos(a) > this->fbestpos(b); });
+
+        for (int k = 0; k < n; k++)
+        {
+            if (order[k] != this->g)
+            {
+                this->reseed[order[k]] = true;
+            }
+        }
+
+        if (this->p.async_threads == 0)
+        {
+            // In the asynchronous PSO, a particle is re-seeded when its
+            // evaluation returns, instead of moved.
+
+            for (int i = 0; i < this->p.popsize; i++)
+            {
+                if (this->reseed[i] == true)
+                {
+                    this->reseed_particle(i);
+                }
+            }
+        }
+
+        // Keep the order of the buffered iteration output.
+        this->tel->flush();
+
+        (*this->output) << "|- Partial restart of " << n << " particles at iteration " << this->iter << "." << '\n';
+    }
+
+    void reseed_particle(int i)
     {
-        // The default swarm update function.
+        // Give a particle a new random position and velocity,
+        // the same way as initialize_arrays().
 
-        this->popul = this->popul + this->vel;
+        for (int j = 0; j < this->p.dim; j++)
+        {
+            this->vel(j, i) = uniform_real(0, 1);
+            this->popul(j, i) =
+                Type(uniform_real(0, 1)) * (this->p.bounds(j, 1) - this->p.bounds(j, 0)) + this->p.bounds(j, 0);
+        }
+
+        this->reseed[i] = false;
+    }
+
+    void record_iteration()
+    {
+        // Pass the state of the current iteration to the telemetry,
+        // which decides if it is recorded.
+
+        this->tel->record(this->iter, this->fbestpos(this->g), this->bestpos.col(this->g), this->evaluations);
+    }
+
+    void swarm_evolution_async(bool &success, double swap_point)
+    {
+        // The asynchronous (steady-state) swarm evolution. Evaluations are
+        // dispatched to a pool of workers, and a particle is moved as soon as
+        // its own evaluation is finished, using the current best particles,
+        // instead of waiting for the whole population at every iteration.
+        // Every popsize finished evaluations count as one iteration.
+
+        std::mutex mutex;
+        std::condition_variable job_signal;
+        std::condition_variable done_signal;
+        std::deque<int> jobs;                  // Particles waiting to be evaluated.
+        std::deque<std::pair<int, Type>> done; // Evaluated particles and their fitness.
+        std::vector<std::thread> workers;
+        bool stop = false;
+        int in_flight = 0;
+        int finished = 0;
+        std::string swap_reason = ""; // The reason of the automatic swap, if any.
+
+        auto worker_task = [&]() {
+            mpfr::mpreal::set_default_prec(this->precision);
+
+            while (true)
+            {
+                int i;
+                Type_Arr particle;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+
+                    job_signal.wait(lock, [&] { return stop == true || jobs.empty() == false; });
+
+                    if (jobs.empty() == true)
+                    {
+                        break;
+                    }
+
+                    i = jobs.front();
+                    jobs.pop_front();
+
+                    particle = this->popul.col(i);
+                }
+
+                Type f = this->obj_function(particle)(0);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+
+                    done.emplace_back(i, f);
+                }
+
+                done_signal.notify_one();
+            }
+
+            mpfr_free_cache2(MPFR_FREE_LOCAL_CACHE);
+        };
+
+        auto dispatch = [&](int i) {
+            // Move particle i and send it to the workers.
+
+            for (int j = 0; j < this->p.dim; j++)
+            {
+                this->R1(j, i) = uniform_real(0, 1);
+                this->R2(j, i) = uniform_real(0, 1);
+            }
+
+            if (this->reseed[i] == true)
+            {
+                this->reseed_particle(i);
+            }
+            else
+            {
+                this->dispatch_dim([&](auto D) {
+                    this->template move_particle<decltype(D)::value>(i, this->w, this->constriction_coeff(),
+                                                                     this->social_attractor(i));
+                });
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                jobs.push_back(i);
+                in_flight++;
+            }
+
+            job_signal.notify_one();
+        };
+
+        auto collect = [&]() {
+            // Wait for one evaluation and update the bests with it.
+
+            std::pair<int, Type> result;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                done_signal.wait(lock, [&] { return done.empty() == false; });
+
+                result = done.front();
+                done.pop_front();
+                in_flight--;
+            }
+
+            int i = result.first;
+
+            this->evaluations++;
+            this->fpopul(i) = result.second;
+
+            if (this->fpopul(i) < this->fbestpos(i))
+            {
+                this->fbestpos(i) = this->fpopul(i);
+                this->bestpos.col(i) = this->popul.col(i);
+
+                if (this->fbestpos(i) < this->fbestpos(this->g))
+                {
+                    this->g = i;
+                }
+            }
+
+            return i;
+        };
+
+        auto print_messages = [&]() {
+            // Write the messages of the evaluations that the workers buffered.
+            // Only this thread writes to the output while the workers run.
+
+            std::string messages = this->Obj_F->take_messages();
+
+            if (messages.empty() == false)
+            {
+                this->tel->flush(); // (keep the order of the buffered iteration output)
+
+                (*this->output) << messages;
+            }
+        };
+
+        if (this->swap_reached(swap_point) == true)
+        {
+            return;
+        }
+        else if (this->iter >= this->p.max_it)
+        {
+            this->end_evolution(success);
+
+            return;
+        }
+
+        this->Obj_F->set_buffered(true);
+
+        for (int i = 0; i < this->p.async_threads; i++)
+        {
+            workers.emplace_back(worker_task);
+        }
+
+        this->iter++;
+
+        if (this->iter <= this->weveryit)
+        {
+            this->w = this->p.max_w - (this->iter - 1) * this->inertdec;
+        }
+
+        this->neighbourhood_update();
+
+        for (int i = 0; i < this->p.popsize; i++)
+        {
+            dispatch(i);
+        }
+
+        // Swarm evolution loop.
+        while (true)
+        {
+            int i = collect();
+
+            print_messages();
+
+            finished++;
+
+            this->check_stop_criterion(success);
+
+            if (finished % this->p.popsize == 0)
+            {
+                this->record_iteration();
+                this->save_checkpoint();
+
+                if (this->iter >= this->p.max_it)
+                {
+                    break;
+                }
+
+                if (success == false && this->check_stagnation() == true)
+                {
+                    break;
+                }
+
+                // (the swap, which moves the best particle, waits for the workers)
+                swap_reason = (success == false) ? this->precision_exhausted() : "";
+
+                if (swap_reason != "")
+                {
+                    break;
+                }
+
+                this->iter++;
+
+                // Update the value of the inertia weight w.
+                if (this->iter <= this->weveryit)
+                {
+                    this->w = this->p.max_w - (this->iter - 1) * this->inertdec;
+                }
+
+                this->neighbourhood_update();
+            }
+
+            if ((success == true) || (swap_point > this->fbestpos(g)))
+            {
+                break;
+            }
+
+            dispatch(i);
+        }
+
+        // Let the workers finish the particles that are still being evaluated,
+        // so that the fitness of every particle matches its position.
+        while (in_flight > 0)
+        {
+            collect();
+        }
+
+        this->check_stop_criterion(success);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            stop = true;
+        }
+
+        job_signal.notify_all();
+
+        for (auto &t : workers)
+        {
+            t.join();
+        }
+
+        this->Obj_F->set_buffered(false);
+
+        print_messages();
+
+        if (success == false && swap_reason != "")
+        {
+            this->set_swap(swap_reason);
+        }
+        else if (success == false && this->status != "stagnated" && swap_point > this->fbestpos(g))
+        {
+            this->set_swap("swap point");
+        }
+        else
+        {
+            this->end_evolution(success);
+        }
+    }
+
+    virtual void swarm_update()
+    {
+        // The default swarm update function. The positions are advanced
+        // by the fused kernel in velocity_update(), so there is nothing
+        // left to do here.
     }
 
     virtual void velocity_update(Type w)
     {
-        // The default velocity update function.
+        // The default velocity update function. It also advances the
+        // positions of the particles, in the same pass.
 
-        int dim = this->p.dim;
-        int popsize = this->p.popsize;
+        uniform_real_fill(this->R1, 0, 1);
+        uniform_real_fill(this->R2, 0, 1);
+
+        this->dispatch_dim([&](auto D) { this->template swarm_kernel<decltype(D)::value>(w); });
+    }
+
+    void evaluate_swarm(std::string type = "")
+    {
+        // Evaluate position. With a tolerance schedule, the population is
+        // evaluated with a coarse ODE tolerance and the particles that are
+        // close to the best one are confirmed at full accuracy.
+
+        this->prepare_evaluation(type);
 
-        Type_Arr A(dim, popsize);
-        Type_Arr R1(dim, popsize);
-        Type_Arr R2(dim, popsize);
+        if (this->p.tol_ratio > 0)
+        {
+            this->Obj_F->set_tolerance(this->scheduled_tolerance());
+            this->fpopul = this->obj_function(this->popul);
+            this->Obj_F->set_tolerance(0);
+            this->confirm_candidates();
+        }
+        else
+        {
+            this->fpopul = this->obj_function(this->popul);
+        }
+
+        this->accept_evaluation(type);
+    }
+
+    Type scheduled_tolerance()
+    {
+        // The ODE tolerance is tol_ratio times the error of the best particle,
+        // so it is loose while the swarm is far from an orbit and it tightens
+        // as the best value approaches gm. It is at most 1e-8, to stay well
+        // within the energy tolerance of the Poincare stop event (1e-6).
+
+        Type tolerance = Type(1e-8);
+
+        if (this->g >= 0 && this->g < this->fbestpos.size())
+        {
+            Type scheduled = this->p.tol_ratio * lmath::abs(this->fbestpos(this->g) - this->p.gm);
+
+            if (scheduled < tolerance)
+            {
+                tolerance = scheduled;
+            }
+        }
+
+        return tolerance;
+    }
+
+    void confirm_candidates()
+    {
+        // Re-evaluate at full accuracy the particles whose coarse fitness is
+        // within twice the error of the best value, before they are accepted.
+        // The best particle is always ranked with full-accuracy values.
+
+        Type best = this->fpopul.minCoeff();
+
+        if (this->g >= 0 && this->g < this->fbestpos.size() && this->fbestpos(this->g) < best)
+        {
+            best = this->fbestpos(this->g);
+        }
 
-        A = bestpos.col(g).replicate(1, bestpos.cols());
+        if (lmath::isinf<Type>(best))
+        { // No particle has a finite fitness.
+            return;
+        }
+
+        Type threshold = this->p.gm + 2 * lmath::abs(best - this->p.gm);
+        std::vector<int> candidates;
+
+        for (int i = 0; i < this->fpopul.size(); i++)
+        {
+            if (this->fpopul(i) <= threshold)
+            {
+                candidates.push_back(i);
+            }
+        }
+
+        if (candidates.size() == 0)
+        {
+            return;
+        }
+
+        Type_Arr particles(this->p.dim, candidates.size());
+
+        for (int k = 0; k < int(candidates.size()); k++)
+        {
+            particles.col(k) = this->popul.col(candidates[k]);
+        }
+
+        Type_Vec f = this->obj_function(particles);
 
-        for (int i = 0; i < bestpos.cols(); i++)
+        for (int k = 0; k < int(candidates.size()); k++)
         {
-            A.col(i) = bestpos.col(g);
+            this->fpopul(candidates[k]) = f(k);
         }
 
-        R1 = Type_Arr::NullaryExpr(dim, popsize, [&]() { return Type(uniform_real(0, 1)); });
-        R2 = Type_Arr::NullaryExpr(dim, popsize, [&]() { return Type(uniform_real(0, 1)); });
-        vel = w * vel + this->p.c1 * R1 * (bestpos - popul) + this->p.c2 * R2 * (A - popul);
+        this->evaluations += candidates.size();
+    }
 
-        this->vel_clamp();
+    virtual void prepare_evaluation(std::string type)
+    {
+        // Called before the population is evaluated.
     }
 
-    virtual void evaluate_swarm(std::string type = "")
+    virtual void accept_evaluation(std::string type)
     {
-        // Evaluate position.
+        // Update the best positions with the new fitness (fpopul).
 
-        this->fpopul = this->obj_function(this->popul);
+        this->evaluations += this->popul.cols();
 
         // Initialize best position matrices.
         if (type == "initial" && this->imported == false)
@@ -446,14 +1843,7 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         }
         else
         {
-            for (int i = 0; i < fpopul.rows(); i++)
-            {
-                if (this->fpopul(i) < this->fbestpos(i))
-                {
-                    this->fbestpos(i) = this->fpopul(i);
-                    this->bestpos.col(i) = this->popul.col(i);
-                }
-            }
+            this->dispatch_dim([&](auto D) { this->template update_best<decltype(D)::value>(); });
         }
 
         // Find the best particle in the population.
@@ -470,7 +1860,7 @@ template <typename Type, typename Type_Arr, typename Type_Vec, typename Type_Emp
         return this->Obj_F->calculate(particle);
     }
 
-    inline virtual Type_Vec obj_function(Type_Arr popul)
+    inline virtual Type_Vec obj_function(const Type_Arr &popul)
     {
         return this->Obj_F->call(popul).array();
     }
@@ -0,0 +1,420 @@
+#ifndef __TELE__
+#define __TELE__
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "../local_definitions.hpp"
+
+struct telemetry_params
+{
+    // A structure that contains the settings of the iteration output
+    // of the PSO algorithms.
+
+    std::string mode = "every";  // "every": every N iterations, "improvement": only when
+                                 // the best particle improves, "off": no output.
+    int every = 1;               // Record every N iterations (mode "every").
+    std::string format = "text"; // "text", "csv" or "binary".
+    std::string file = "";       // The file of the records (required for "csv" and "binary").
+                                 // If empty, the text records go to the output stream.
+};
+
+struct telemetry_record
+{
+    // The state of the swarm at one iteration.
+
+    int iter;
+    double best_f;
+    long evaluations;
+    double wall_time; // Seconds since the start of the run.
+    std::vector<double> best_pos;
+};
+
+class telemetry_sink
+{
+    // The interface of the telemetry output. The records are kept in a
+    // buffer and written to the output stream in large blocks, instead
+    // of flushing the stream on every line.
+
+  public:
+    telemetry_sink(std::ostream *output)
+    {
+        this->output = output;
+    }
+
+    virtual ~telemetry_sink()
+    {
+        this->flush();
+    }
+
+    virtual void write(const telemetry_record &r) = 0;
+
+    virtual void resume() {};
+
+    virtual void clear() {};
+
+    void flush()
+    {
+        if (this->buffer.tellp() > 0)
+        {
+            (*this->output) << this->buffer.str();
+            this->output->flush();
+
+            this->buffer.str("");
+            this->buffer.clear();
+        }
+    }
+
+  protected:
+    std::ostream *output;
+    std::ostringstream buffer;
+
+    void check_buffer()
+    {
+        // Write the buffer to the output when it becomes large.
+
+        if (this->buffer.tellp() > (1 << 16))
+        {
+            this->flush();
+        }
+    }
+};
+
+class text_sink : public telemetry_sink
+{
+    // The human readable iteration output.
+
+  public:
+    text_sink(std::ostream *output) : telemetry_sink(output)
+    {
+        this->buffer << std::setprecision(16);
+    }
+
+    void write(const telemetry_record &r) override
+    {
+        Eigen::Map<const Eigen::Array<double, 1, Eigen::Dynamic>> pos(r.best_pos.data(), r.best_pos.size());
+
+        this->buffer << "|----------------- " << '\n';
+        this->buffer << "|- Iteration     : " << r.iter << '\n';
+        this->buffer << "|- Error         : " << r.best_f << '\n';
+        this->buffer << "|- Best Particle : " << pos << '\n';
+        this->buffer << "|----------------- " << '\n';
+
+        this->check_buffer();
+    }
+};
+
+class csv_sink : public telemetry_sink
+{
+    // One line per record: iter,best_f,evaluations,wall_time,x_0,...,x_dim-1
+
+  public:
+    csv_sink(std::ostream *output) : telemetry_sink(output)
+    {
+        this->header = false;
+        this->buffer << std::setprecision(17);
+    }
+
+    void write(const telemetry_record &r) override
+    {
+        if (this->header == false)
+        {
+            this->buffer << "iter,best_f,evaluations,wall_time";
+
+            for (size_t i = 0; i < r.best_pos.size(); i++)
+            {
+                this->buffer << ",x_" << i;
+            }
+
+            this->buffer << '\n';
+            this->header = true;
+        }
+
+        this->buffer << r.iter << ',' << r.best_f << ',' << r.evaluations << ',' << r.wall_time;
+
+        for (size_t i = 0; i < r.best_pos.size(); i++)
+        {
+            this->buffer << ',' << r.best_pos[i];
+        }
+
+        this->buffer << '\n';
+
+        this->check_buffer();
+    }
+
+    void resume() override
+    {
+        // The records continue those of a previous model in the same
+        // output, so the header is not written again.
+
+        this->header = true;
+    }
+
+    void clear() override
+    {
+        // The output was emptied, the header is written again.
+
+        this->header = false;
+    }
+
+  private:
+    bool header; // True if the header line is written.
+};
+
+class binary_sink : public telemetry_sink
+{
+    // Fixed layout records in native byte order:
+    // int32 iter, int32 dim, double best_f, int64 evaluations, double wall_time, double best_pos[dim].
+
+  public:
+    binary_sink(std::ostream *output) : telemetry_sink(output) {};
+
+    void write(const telemetry_record &r) override
+    {
+        int32_t iter = r.iter;
+        int32_t dim = r.best_pos.size();
+        int64_t evaluations = r.evaluations;
+
+        this->buffer.write(reinterpret_cast<const char *>(&iter), sizeof(iter));
+        this->buffer.write(reinterpret_cast<const char *>(&dim), sizeof(dim));
+        this->buffer.write(reinterpret_cast<const char *>(&r.best_f), sizeof(r.best_f));
+        this->buffer.write(reinterpret_cast<const char *>(&evaluations), sizeof(evaluations));
+        this->buffer.write(reinterpret_cast<const char *>(&r.wall_time), sizeof(r.wall_time));
+        this->buffer.write(reinterpret_cast<const char *>(r.best_pos.data()), dim * sizeof(double));
+
+        this->check_buffer();
+    }
+};
+
+class telemetry
+{
+    // Decides which iterations are recorded (sampling) and passes
+    // them to the sink of the selected format.
+
+  public:
+    telemetry(const telemetry_params &tp, std::ostream *output)
+    {
+        this->tp = tp;
+        this->sink = nullptr;
+        this->file = nullptr;
+        this->offset = 0;
+        this->start = std::chrono::steady_clock::now();
+        this->reset_best();
+
+        if (this->tp.mode == "off")
+        {
+            return;
+        }
+
+        if (this->tp.file != "")
+        {
+            // The records go only to their own file, not to the output with
+            // the rest of the messages. Every model of a run (double, dd_real
+            // and mp_real) appends its records to it, the file is emptied
+            // once at the start of the run (see clear()).
+
+            this->file = new std::ofstream(this->tp.file, std::ios::out | std::ios::app | this->file_mode());
+
+            output = this->file;
+        }
+
+        if (this->tp.format == "csv")
+        {
+            this->sink = new csv_sink(output);
+        }
+        else if (this->tp.format == "binary")
+        {
+            this->sink = new binary_sink(output);
+        }
+        else
+        {
+            this->sink = new text_sink(output);
+        }
+    }
+
+    ~telemetry()
+    {
+        if (this->sink != nullptr)
+        {
+            delete this->sink;
+            this->sink = nullptr;
+        }
+
+        if (this->file != nullptr)
+        {
+            delete this->file;
+            this->file = nullptr;
+        }
+    }
+
+    static bool check_params(const telemetry_params &tp)
+    {
+        // Returns false if the telemetry parameters are not valid.
+
+        if (tp.mode != "every" && tp.mode != "improvement" && tp.mode != "off")
+        {
+            std::cout << "~> Error: The telemetry mode should be [every], [improvement] or [off]." << std::endl;
+
+            return false;
+        }
+        else if (tp.format != "text" && tp.format != "csv" && tp.format != "binary")
+        {
+            std::cout << "~> Error: The telemetry format should be [text], [csv] or [binary]." << std::endl;
+
+            return false;
+        }
+        else if (tp.every < 1)
+        {
+            std::cout << "~> Error: The telemetry should record at least every 1 iteration." << std::endl;
+
+            return false;
+        }
+        else if (tp.format != "text" && tp.mode != "off" && tp.file == "")
+        {
+            std::cout << "~> Error: The csv and binary telemetry records need their own file (tp.file)." << std::endl;
+
+            return false;
+        }
+
+        return true;
+    }
+
+    void restart(double offset = 0)
+    {
+        // Restart the clock of the run. The offset is the time spent
+        // before (e.g. in the double model, before the swap point).
+
+        this->offset = offset;
+        this->start = std::chrono::steady_clock::now();
+        this->reset_best();
+    }
+
+    void resume(double offset)
+    {
+        // Continue the run of another model (e.g. the mp_real model after
+        // the swap point), in the same output.
+
+        this->restart(offset);
+
+        if (this->sink != nullptr)
+        {
+            this->sink->resume();
+        }
+    }
+
+    double elapsed()
+    {
+        return this->offset + std::chrono::duration<double>(std::chrono::steady_clock::now() - this->start).count();
+    }
+
+    template <typename Type, typename Type_Col>
+    void record(int iter, const Type &best_f, const Type_Col &best_pos, long evaluations)
+    {
+        if (this->sink == nullptr)
+        {
+            return;
+        }
+
+        if (this->tp.mode == "every" && iter % this->tp.every != 0)
+        {
+            return;
+        }
+        else if (this->tp.mode == "improvement")
+        {
+            // Compare in Type, an improvement of the mp_real model can be
+            // smaller than the resolution of double.
+
+            Type &last_best = this->get_last_best<Type>();
+
+            if (!(best_f < last_best))
+            {
+                return;
+            }
+
+            last_best = best_f;
+        }
+
+        telemetry_record r;
+
+        r.iter = iter;
+        r.best_f = double(best_f);
+        r.evaluations = evaluations;
+        r.wall_time = this->elapsed();
+        r.best_pos.resize(best_pos.size());
+
+        for (int i = 0; i < int(best_pos.size()); i++)
+        {
+            r.best_pos[i] = double(best_pos(i));
+        }
+
+        this->sink->write(r);
+    }
+
+    void flush()
+    {
+        if (this->sink != nullptr)
+        {
+            this->sink->flush();
+        }
+    }
+
+    void clear()
+    {
+        // Empty the file of the records, at the start of a new run (not when
+        // a run is resumed, or by the models that continue it).
+
+        if (this->file == nullptr)
+        {
+            return;
+        }
+
+        this->flush();
+        this->file->flush();
+
+        std::ofstream(this->tp.file, std::ios::out | std::ios::trunc | this->file_mode());
+
+        this->sink->clear();
+    }
+
+  private:
+    telemetry_params tp;
+    telemetry_sink *sink;
+    std::ofstream *file;  // The file of the records (tp.file), if any.
+    double offset;        // Seconds spent before the restart of the clock.
+    double last_best;     // The last recorded best fitness (mode "improvement"),
+    DD_REAL last_best_dd; // kept in the type of the model.
+    MP_REAL last_best_mp;
+    std::chrono::steady_clock::time_point start;
+
+    template <typename Type> Type &get_last_best()
+    {
+        if constexpr (std::is_same_v<Type, MP_REAL>)
+        {
+            return this->last_best_mp;
+        }
+        else if constexpr (std::is_same_v<Type, DD_REAL>)
+        {
+            return this->last_best_dd;
+        }
+        else
+        {
+            return this->last_best;
+        }
+    }
+
+    void reset_best()
+    {
+        this->last_best = std::numeric_limits<double>::infinity();
+        this->last_best_dd = DD_REAL(this->last_best);
+        this->last_best_mp = MP_REAL(this->last_best);
+    }
+
+    std::ios::openmode file_mode()
+    {
+        return (this->tp.format == "binary") ? std::ios::binary : std::ios::openmode(0);
+    }
+};
+
+#endif